@@ -0,0 +1,458 @@
+// starSense_bench: microbenchmarks for the core kernels and end-to-end
+// runSimulation throughput. Standalone, no Python dependency.
+//
+// usage: starSense_bench [--filter SUBSTR] [--min-time SECONDS]
+//                        [--repetitions N] [--json PATH] [--list]
+//
+// Each benchmark is timed for at least --min-time seconds per repetition and
+// the fastest repetition is reported (least disturbed by other load). The
+// JSON output follows Google Benchmark's layout so existing trend tooling
+// can read it.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api.hpp"
+
+using namespace starSense;
+
+namespace {
+
+// ----------------------------------------------------------
+// Harness
+// ----------------------------------------------------------
+
+// Keep the compiler from discarding or constant-folding benchmark work
+template <typename T>
+inline void doNotOptimize(T &value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+struct BenchOptions {
+    std::string filter;
+    double minTime = 0.2;   // [s] per repetition
+    int repetitions = 3;
+    std::string jsonPath;
+};
+
+struct BenchResult {
+    std::string name;
+    std::string unit;         // what one "op" is: "op" or "step"
+    std::uint64_t iterations; // ops in the reported repetition
+    double nsPerOp;
+    double opsPerSecond;
+};
+
+// body(iterations) runs the workload and returns how many ops it performed
+using BenchBody = std::function<std::uint64_t(std::uint64_t)>;
+
+struct Benchmark {
+    std::string name;
+    std::string unit;
+    BenchBody body;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+BenchResult runBenchmark(const Benchmark &bench, const BenchOptions &opts) {
+    // Calibrate: grow the iteration count until one batch takes a measurable
+    // fraction of minTime, then scale to minTime
+    std::uint64_t iterations = 1;
+    double elapsed = 0.0;
+    for (;;) {
+        const auto start = std::chrono::steady_clock::now();
+        bench.body(iterations);
+        elapsed = secondsSince(start);
+        if (elapsed >= 0.1 * opts.minTime || iterations >= (std::uint64_t{1} << 40)) {
+            break;
+        }
+        iterations *= 10;
+    }
+    if (elapsed > 0.0) {
+        iterations = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(iterations * opts.minTime / elapsed));
+    }
+
+    BenchResult best{bench.name, bench.unit, 0, 0.0, 0.0};
+    for (int rep = 0; rep < opts.repetitions; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::uint64_t ops = bench.body(iterations);
+        const double seconds = secondsSince(start);
+
+        const double nsPerOp = seconds * 1e9 / static_cast<double>(ops);
+        if (rep == 0 || nsPerOp < best.nsPerOp) {
+            best.iterations = ops;
+            best.nsPerOp = nsPerOp;
+            best.opsPerSecond = 1e9 / nsPerOp;
+        }
+    }
+    return best;
+}
+
+std::string jsonEscape(const std::string &s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void writeJson(const std::string &path, const BenchOptions &opts, const std::vector<BenchResult> &results) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("starSense_bench: cannot open " + path);
+    }
+
+    char date[64];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"starSense_bench\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"min_time\": " << opts.minTime << ",\n";
+    out << "    \"repetitions\": " << opts.repetitions << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, "
+            "\"real_time\": %.6g, \"time_unit\": \"ns\", \"items_per_second\": %.6g}%s\n",
+            jsonEscape(r.name).c_str(), r.unit.c_str(),
+            static_cast<unsigned long long>(r.iterations),
+            r.nsPerOp, r.opsPerSecond,
+            (i + 1 < results.size()) ? "," : "");
+        out << line;
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+// ----------------------------------------------------------
+// Fixtures
+// ----------------------------------------------------------
+
+const Mat3 kInertia{{
+    {{2.0, 0.1, 0.05}},
+    {{0.1, 3.0, 0.2}},
+    {{0.05, 0.2, 4.0}}
+}};
+
+const AttitudeState kState{normalize(Quat{0.9, 0.3, 0.2, 0.1}), Vec3{0.1, -0.2, 0.05}};
+
+AttitudeSimParams baseParams() {
+    AttitudeSimParams p;
+    p.q0 = kState.q;
+    p.w0 = kState.w;
+    p.qRef = Quat{1.0, 0.0, 0.0, 0.0};
+    p.wRef = Vec3{0.0, 0.0, 0.0};
+    p.inertiaBody = kInertia;
+    p.dt = 0.01;
+    p.numSteps = 2000;
+    p.controlRateHz = 10.0;
+    p.kpAtt = Vec3{2.0, 2.0, 2.0};
+    p.kdRate = Vec3{3.0, 3.0, 3.0};
+    p.kLqr = lqrAttitudeGain(kInertia, Vec3{4.0, 4.0, 4.0}, Vec3{1.0, 1.0, 1.0}, Vec3{1.0, 1.0, 1.0});
+    p.wheelInertias = {0.05, 0.05, 0.05};
+    return p;
+}
+
+// ----------------------------------------------------------
+// Kernel microbenchmarks (one op = one call)
+// ----------------------------------------------------------
+
+void addKernelBenchmarks(std::vector<Benchmark> &out) {
+    out.push_back({"util/quatMultiply", "op", [](std::uint64_t n) {
+        Quat q = kState.q;
+        const Quat dq = quatFromRotationVector(Vec3{1e-3, -2e-3, 5e-4});
+        for (std::uint64_t i = 0; i < n; ++i) {
+            q = quatMultiply(q, dq);
+            doNotOptimize(q);
+        }
+        return n;
+    }});
+
+    out.push_back({"util/quatFromRotationVector", "op", [](std::uint64_t n) {
+        Vec3 phi{0.01, -0.02, 0.005};
+        for (std::uint64_t i = 0; i < n; ++i) {
+            doNotOptimize(phi);
+            Quat q = quatFromRotationVector(phi);
+            doNotOptimize(q);
+        }
+        return n;
+    }});
+
+    out.push_back({"dynamics/RigidBody/computeDerivative", "op", [](std::uint64_t n) {
+        const RigidBodyDynamics dyn(kInertia);
+        AttitudeState x = kState;
+        const Vec3 tau{0.01, 0.0, -0.01};
+        for (std::uint64_t i = 0; i < n; ++i) {
+            doNotOptimize(x);
+            AttitudeState dx = dyn.computeDerivative(0.0, x, tau);
+            doNotOptimize(dx);
+        }
+        return n;
+    }});
+
+    // Steppers as runSimulation uses them: method fixed at compile time
+    auto stepperBench = [](auto integrator) {
+        return [integrator](std::uint64_t n) {
+            const RigidBodyDynamics dyn(kInertia);
+            AttitudeState x = kState;
+            const Vec3 tau{0.01, 0.0, -0.01};
+            double t = 0.0;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                x = integrator.step(dyn, t, x, 0.01, tau);
+                t += 0.01;
+                doNotOptimize(x);
+            }
+            return n;
+        };
+    };
+    out.push_back({"integrator/euler/step", "op",
+        stepperBench(StaticIntegrator<IntegrationMethod::Euler>())});
+    out.push_back({"integrator/rk4/step", "op",
+        stepperBench(StaticIntegrator<IntegrationMethod::RK4>())});
+    out.push_back({"integrator/rkmk4/step", "op",
+        stepperBench(StaticIntegrator<IntegrationMethod::RKMK4>())});
+
+    // One control-law evaluation
+    const AttitudeSimParams params = baseParams();
+    const ReferenceState ref{Quat{1.0, 0.0, 0.0, 0.0}, Vec3{0.0, 0.0, 0.0}};
+    auto controllerBench = [ref](auto controller) {
+        return [controller, ref](std::uint64_t n) {
+            ControllerState state;
+            AttitudeState x = kState;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                doNotOptimize(x);
+                Vec3 tau = controller.computeCommandTorque(1.0, x, ref, state);
+                doNotOptimize(tau);
+            }
+            return n;
+        };
+    };
+    out.push_back({"controller/pd/computeCommandTorque", "op",
+        controllerBench(PDController(params.kpAtt, params.kdRate))});
+    out.push_back({"controller/lqr/computeCommandTorque", "op",
+        controllerBench(LQRController(params.kLqr))});
+
+    auto actuatorBench = [](auto actuator) {
+        return [actuator](std::uint64_t n) {
+            ActuatorState state = actuator.initialState();
+            const Vec3 command{0.01, -0.02, 0.005};
+            double t = 0.0;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                Vec3 tau = actuator.applyCommand(t, kState, command, state);
+                doNotOptimize(tau);
+                t += 0.01;
+            }
+            return n;
+        };
+    };
+    out.push_back({"actuator/ideal/applyCommand", "op", actuatorBench(IdealTorqueActuator{})});
+    out.push_back({"actuator/reactionWheel/applyCommand", "op", actuatorBench(ReactionWheelActuator(
+        params.wheelAxes, params.wheelInertias, params.maxWheelTorque,
+        params.maxWheelSpeed, params.wheelSpeeds0))});
+
+    // Redundant arrays: 4-wheel pyramid and a 12-wheel cluster, with
+    // null-space momentum management
+    auto wheelArrayBench = [&](std::size_t numWheels) {
+        std::vector<Vec3> axes;
+        for (std::size_t i = 0; i < numWheels; ++i) {
+            const double az = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(numWheels);
+            const double el = (i % 2 == 0) ? 0.6 : -0.6;
+            axes.push_back(Vec3{std::cos(el) * std::cos(az), std::cos(el) * std::sin(az), std::sin(el)});
+        }
+        const std::vector<double> inertias(numWheels, 0.01), maxTorque(numWheels, 0.1),
+            maxSpeed(numWheels, 6000.0), speeds0(numWheels, 100.0);
+        const ReactionWheelActuator actuator(axes, inertias, maxTorque, maxSpeed, speeds0, 0.1);
+
+        // Restart from the initial speeds periodically: left alone, the
+        // null-space momentum error decays into subnormal numbers, which
+        // would time the FPU's slow path rather than the allocator
+        return [actuator](std::uint64_t n) {
+            ActuatorState state = actuator.initialState();
+            const Vec3 command{0.01, -0.02, 0.005};
+            double t = 0.0;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                if ((i & 0xFFFF) == 0xFFFF) {
+                    state.wheelSpeeds.assign(state.wheelSpeeds.size(), 100.0);
+                }
+                Vec3 tau = actuator.applyCommand(t, kState, command, state);
+                doNotOptimize(tau);
+                t += 0.01;
+            }
+            return n;
+        };
+    };
+    out.push_back({"actuator/reactionWheel4/applyCommand", "op", wheelArrayBench(4)});
+    out.push_back({"actuator/reactionWheel12/applyCommand", "op", wheelArrayBench(12)});
+
+    out.push_back({"lqr/lqrAttitudeGain", "op", [](std::uint64_t n) {
+        Vec3 qAtt{4.0, 5.0, 6.0};
+        for (std::uint64_t i = 0; i < n; ++i) {
+            doNotOptimize(qAtt);
+            Mat3x6 K = lqrAttitudeGain(kInertia, qAtt, Vec3{1.0, 1.0, 1.0}, Vec3{0.5, 0.5, 0.5});
+            doNotOptimize(K);
+        }
+        return n;
+    }});
+}
+
+// ----------------------------------------------------------
+// End-to-end runs (one op = one simulation step)
+// ----------------------------------------------------------
+
+void addSimulationBenchmarks(std::vector<Benchmark> &out) {
+    const char *integrators[] = {"euler", "rk4", "rk45", "rkmk4"};
+    const char *controllers[] = {"zero", "pd", "lqr"};
+    const char *actuators[] = {"ideal", "reactionWheel"};
+
+    for (const char *integrator : integrators) {
+        for (const char *controller : controllers) {
+            for (const char *actuator : actuators) {
+                AttitudeSimParams params = baseParams();
+                params.integratorType = integrator;
+                params.controllerType = controller;
+                params.actuatorType = actuator;
+
+                const std::string name = std::string("runSimulation/") +
+                    integrator + "/" + controller + "/" + actuator;
+                out.push_back({name, "step", [params](std::uint64_t n) {
+                    std::uint64_t steps = 0;
+                    for (std::uint64_t i = 0; i < n; ++i) {
+                        SimulationResult result = runSimulation(params);
+                        doNotOptimize(result);
+                        steps += static_cast<std::uint64_t>(params.numSteps);
+                    }
+                    return steps;
+                }});
+            }
+        }
+    }
+
+    // Lock-step ensemble: one op = one case advanced by one step, single
+    // thread, so it compares directly with runSimulation/rk4/* above
+    for (const char *controller : {"pd", "lqr"}) {
+        const AttitudeSimParams params = baseParams();
+        EnsembleCase c{params.q0, params.w0, params.inertiaBody, params.qRef, params.wRef, {}};
+        c.gain = (std::string(controller) == "pd") ? pdGainMatrix(params.kpAtt, params.kdRate) : params.kLqr;
+
+        std::vector<EnsembleCase> cases(1024, c);
+        for (std::size_t i = 0; i < cases.size(); ++i) {
+            cases[i].w0[0] += 1e-4 * static_cast<double>(i);
+        }
+        const EnsembleConfig cfg{params.dt, 200, params.controlRateHz};
+
+        out.push_back({std::string("propagateEnsemble/rk4/") + controller + "/x1024", "step",
+            [cases, cfg](std::uint64_t n) {
+            std::uint64_t steps = 0;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                EnsembleResult result = propagateEnsemble(cases, cfg, 1);
+                doNotOptimize(result);
+                steps += cases.size() * static_cast<std::uint64_t>(cfg.numSteps);
+            }
+            return steps;
+        }});
+    }
+
+    // Whole-machine throughput: many cases through the worker pool
+    out.push_back({"runSimulationBatch/rk4/pd/ideal/x64", "step", [](std::uint64_t n) {
+        AttitudeSimParams params = baseParams();
+        params.controllerType = "pd";
+        const std::vector<AttitudeSimParams> cases(64, params);
+        std::uint64_t steps = 0;
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::vector<SimulationResult> results = runSimulationBatch(cases);
+            doNotOptimize(results);
+            steps += cases.size() * static_cast<std::uint64_t>(params.numSteps);
+        }
+        return steps;
+    }});
+}
+
+void printUsage() {
+    std::printf(
+        "usage: starSense_bench [--filter SUBSTR] [--min-time SECONDS]\n"
+        "                       [--repetitions N] [--json PATH] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions opts;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("starSense_bench: missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") {
+            opts.filter = value();
+        } else if (arg == "--min-time") {
+            opts.minTime = std::stod(value());
+        } else if (arg == "--repetitions") {
+            opts.repetitions = std::max(1, std::stoi(value()));
+        } else if (arg == "--json") {
+            opts.jsonPath = value();
+        } else if (arg == "--list") {
+            listOnly = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks;
+    addKernelBenchmarks(benchmarks);
+    addSimulationBenchmarks(benchmarks);
+
+    std::vector<BenchResult> results;
+    std::printf("%-48s %14s %19s %12s\n", "benchmark", "time/op", "throughput", "iterations");
+    for (const Benchmark &bench : benchmarks) {
+        if (!opts.filter.empty() && bench.name.find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        if (listOnly) {
+            std::printf("%s\n", bench.name.c_str());
+            continue;
+        }
+
+        const BenchResult r = runBenchmark(bench, opts);
+        std::printf("%-48s %11.2f ns %11.4g %-7s %12llu\n",
+            r.name.c_str(), r.nsPerOp, r.opsPerSecond, (r.unit + "/s").c_str(),
+            static_cast<unsigned long long>(r.iterations));
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    if (!opts.jsonPath.empty()) {
+        writeJson(opts.jsonPath, opts, results);
+    }
+    return 0;
+}
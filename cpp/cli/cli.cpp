@@ -0,0 +1,266 @@
+// starSense_cli: run simulations from a config file without Python.
+//
+// usage: starSense_cli CONFIG [--format csv|sstraj|none] [--out PREFIX]
+//                             [--float32] [--threads N] [--quiet]
+//
+// CONFIG is JSON, JSON Lines or TOML (see paramsFile.hpp) holding one or
+// more cases. Case i is written to PREFIX_NNNN.csv / PREFIX_NNNN.sstraj
+// (i zero-padded to four digits, e.g. run_0007.csv), or PREFIX.csv /
+// PREFIX.sstraj when there is a single case. Samples are
+// streamed to the output while each run progresses, so memory stays bounded
+// by params.logChunkSize. Cases run in parallel on --threads workers.
+// Cases with summaryOnly write no file; their summary metrics are reported.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+#include "paramsFile.hpp"
+
+using namespace starSense;
+
+namespace {
+
+struct CliOptions {
+    std::string configPath;
+    std::string format = "csv";
+    std::string outPrefix = "starSense";
+    bool float32 = false;
+    int numThreads = 0;
+    bool quiet = false;
+};
+
+// Streams logged chunks to a CSV file: one row per grid sample, one column
+// per channel component (quats_0 ... quats_3, ...). Per-interval channels
+// (the torques) have no value at the final sample; that cell is left empty.
+// `layout` names the optional channels the run logs.
+class CsvSink {
+public:
+    CsvSink(const std::string &path, const ChannelLayout &layout)
+        : path_(path),
+          file_(std::fopen(path.c_str(), "w"))
+    {
+        if (!file_) {
+            throw std::runtime_error("starSense_cli: cannot open " + path);
+        }
+
+        bool first = true;
+        SimulationResult columns;
+        columns.setLayout(layout);
+        columns.forEachChannel([&](const char *name, const auto &channel, bool) {
+            const std::size_t width = channelWidth(channel);
+            for (std::size_t k = 0; k < width; ++k) {
+                std::fprintf(file_, first ? "%s" : ",%s",
+                    (width == 1) ? name : (std::string(name) + "_" + std::to_string(k)).c_str());
+                first = false;
+            }
+        });
+        std::fputc('\n', file_);
+    }
+
+    ~CsvSink() {
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    CsvSink(const CsvSink &) = delete;
+    CsvSink &operator=(const CsvSink &) = delete;
+
+    void write(const SimulationResult &chunk) {
+        const std::size_t rows = chunk.time.size();
+        for (std::size_t r = 0; r < rows; ++r) {
+            bool first = true;
+            chunk.forEachChannel([&](const char *, const auto &channel, bool) {
+                const std::size_t width = channelWidth(channel);
+                const double *row = (r < channel.size()) ? channelData(channel) + r * width : nullptr;
+                for (std::size_t k = 0; k < width; ++k) {
+                    if (!first) {
+                        std::fputc(',', file_);
+                    }
+                    first = false;
+                    if (row) {
+                        std::fprintf(file_, "%.17g", row[k]);
+                    }
+                }
+            });
+            std::fputc('\n', file_);
+        }
+        rows_ += rows;
+    }
+
+    void close() {
+        const int rc = std::fclose(file_);
+        file_ = nullptr;
+        if (rc != 0) {
+            throw std::runtime_error("starSense_cli: error writing " + path_);
+        }
+    }
+
+    std::size_t rows() const { return rows_; }
+
+private:
+    std::string path_;
+    std::FILE *file_;
+    std::size_t rows_ = 0;
+};
+
+std::string outputPath(const CliOptions &opts, std::size_t index, std::size_t count, const char *ext) {
+    if (count == 1) {
+        return opts.outPrefix + ext;
+    }
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_%04zu", index);
+    return opts.outPrefix + suffix + ext;
+}
+
+// Run one case and write its output; returns a one-line report
+std::string runCase(const CliOptions &opts, AttitudeSimParams params, std::size_t index, std::size_t count) {
+    const auto start = std::chrono::steady_clock::now();
+    std::string target = "(no output)";
+    std::size_t rows = 0;
+    SimulationResult result;
+
+    if (params.summaryOnly) {
+        // No samples to write
+        result = runSimulation(params);
+    } else if (opts.format == "csv") {
+        target = outputPath(opts, index, count, ".csv");
+        CsvSink csv(target, channelLayout(params));
+        result = runSimulation(params, [&csv](const SimulationResult &chunk) { csv.write(chunk); });
+        csv.close();
+        rows = csv.rows();
+    } else {
+        if (opts.format == "sstraj") {
+            target = outputPath(opts, index, count, ".sstraj");
+            params.trajectoryPath = target;
+            params.trajectoryFloat32 = params.trajectoryFloat32 || opts.float32;
+        }
+        // Still stream, so a long run does not hold every sample (a terminal
+        // event may end it before numSteps)
+        result = runSimulation(params, [&rows](const SimulationResult &chunk) { rows += chunk.time.size(); });
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    char line[512];
+    std::snprintf(line, sizeof(line), "case %zu: %zu samples -> %s (%.1f ms)",
+                  index, rows, target.c_str(), ms);
+    std::string report = line;
+    for (const EventOccurrence &e : result.events) {
+        std::snprintf(line, sizeof(line), "; %s at t = %.6g s", e.name.c_str(), e.t);
+        report += line;
+    }
+    if (result.terminated) {
+        report += " (stopped)";
+    }
+    if (params.summaryMetrics || params.summaryOnly) {
+        const SimulationSummary &s = result.summary;
+        std::snprintf(line, sizeof(line),
+            "; settling %.6g s, peak |e| %.6g rad, RMS |e| %.6g rad, impulse %.6g N m s, "
+            "saturated %.6g s, max wheel %.6g RPM",
+            s.settlingTime, s.peakAttitudeError, s.rmsAttitudeError, s.controlImpulse,
+            s.saturationTime, s.maxWheelSpeed);
+        report += line;
+    }
+    return report;
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+        "usage: starSense_cli CONFIG [--format csv|sstraj|none] [--out PREFIX]\n"
+        "                            [--float32] [--threads N] [--quiet]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    CliOptions opts;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--format") {
+                opts.format = value();
+            } else if (arg == "--out") {
+                opts.outPrefix = value();
+            } else if (arg == "--float32") {
+                opts.float32 = true;
+            } else if (arg == "--threads") {
+                const std::string text = value();
+                std::size_t end = 0;
+                try {
+                    opts.numThreads = std::stoi(text, &end);
+                } catch (const std::exception &) {
+                    end = 0;
+                }
+                if (end == 0 || end != text.size()) {
+                    throw std::invalid_argument("--threads expects an integer, got '" + text + "'");
+                }
+            } else if (arg == "--quiet") {
+                opts.quiet = true;
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else if (opts.configPath.empty()) {
+                opts.configPath = arg;
+            } else {
+                throw std::invalid_argument("more than one config file given");
+            }
+        }
+        if (opts.configPath.empty()) {
+            throw std::invalid_argument("no config file given");
+        }
+        if (opts.format != "csv" && opts.format != "sstraj" && opts.format != "none") {
+            throw std::invalid_argument("unsupported --format " + opts.format);
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "starSense_cli: %s\n", e.what());
+        printUsage();
+        return 2;
+    }
+
+    std::vector<AttitudeSimParams> cases;
+    try {
+        cases = loadParamsFile(opts.configPath);
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "starSense_cli: %s\n", e.what());
+        return 2;
+    }
+
+    // Failures are reported per case; the other cases still run
+    std::vector<std::string> reports(cases.size());
+    std::vector<char> failed(cases.size(), 0);
+    parallelFor(cases.size(), opts.numThreads, [&](std::size_t i) {
+        try {
+            reports[i] = runCase(opts, cases[i], i, cases.size());
+        } catch (const std::exception &e) {
+            reports[i] = "case " + std::to_string(i) + ": error: " + e.what();
+            failed[i] = 1;
+        }
+    });
+
+    int status = 0;
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        if (failed[i]) {
+            std::fprintf(stderr, "%s\n", reports[i].c_str());
+            status = 1;
+        } else if (!opts.quiet) {
+            std::printf("%s\n", reports[i].c_str());
+        }
+    }
+    return status;
+}
@@ -7,10 +7,12 @@ namespace starSense {
 Vec3 IdealTorqueActuator::applyCommand(
     double t,
     const AttitudeState &state,
-    const Vec3 &command
+    const Vec3 &command,
+    ActuatorState &actState
 ) const {
-    (void)t;     // unused in ideal model
-    (void)state; // unused in ideal model
+    (void)t;        // unused in ideal model
+    (void)state;    // unused in ideal model
+    (void)actState; // ideal model carries no state
 
     // Ideal actuator: applied torque = commanded torque
     return command;
@@ -22,78 +24,145 @@ ReactionWheelActuator::ReactionWheelActuator(
     const std::vector<double>& wheelInertias,
     const std::vector<double>& maxTorque,
     const std::vector<double>& maxSpeed,
-    const std::vector<double>& initialSpeeds
+    const std::vector<double>& initialSpeeds,
+    double nullSpaceGain,
+    const std::vector<double>& targetSpeeds
 )
-    : wheelAxes_(wheelAxes)
+    : allocator_(wheelAxes)
     , wheelInertias_(wheelInertias)
+    , speedRate_(wheelInertias.size())
     , maxTorque_(maxTorque)
+    , invMaxTorque_(maxTorque.size())
     , maxSpeedRPM_(maxSpeed)
-    , wheelSpeeds_(initialSpeeds)
-    , lastTime_(-1.0)
+    , initialSpeeds_(initialSpeeds)
+    , nullSpaceGain_(nullSpaceGain)
+    , targetSpeeds_(targetSpeeds.empty() ? std::vector<double>(wheelAxes.size(), 0.0) : targetSpeeds)
 {
-    size_t n = wheelAxes_.size();
+    size_t n = wheelAxes.size();
     if (wheelInertias_.size() != n ||
         maxTorque_.size() != n ||
         maxSpeedRPM_.size() != n ||
-        wheelSpeeds_.size() != n) {
+        initialSpeeds_.size() != n ||
+        targetSpeeds_.size() != n) {
         throw std::invalid_argument(
             "ReactionWheelActuator: all wheel parameter vectors must have the same size");
     }
+    if (nullSpaceGain_ < 0.0) {
+        throw std::invalid_argument("ReactionWheelActuator: nullSpaceGain must be >= 0");
+    }
 
-    // Normalize wheel axes
-    for (auto& axis : wheelAxes_) {
-        double norm = std::sqrt(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
-        if (norm > 1e-10) {
-            axis[0] /= norm;
-            axis[1] /= norm;
-            axis[2] /= norm;
+    for (size_t i = 0; i < n; ++i) {
+        if (!(maxTorque_[i] > 0.0)) {
+            throw std::invalid_argument("ReactionWheelActuator: maxTorque must be > 0");
         }
+        invMaxTorque_[i] = 1.0 / maxTorque_[i];
+        // Wheels with negligible inertia keep their speed
+        speedRate_[i] = (wheelInertias_[i] > 1e-12) ? RADS_TO_RPM / wheelInertias_[i] : 0.0;
+    }
+}
+
+ActuatorState ReactionWheelActuator::initialState() const {
+    ActuatorState actState;
+    actState.wheelSpeeds = initialSpeeds_;
+    actState.wheelTorques.assign(allocator_.size(), 0.0);
+    actState.nullSpaceTorques.assign(allocator_.size(), 0.0);
+    return actState;
+}
+
+Vec3 ReactionWheelActuator::rotorMomentum(const ActuatorState &actState) const {
+    // h = sum_i a_i I_i Omega_i
+    Vec3 h{0.0, 0.0, 0.0};
+    for (size_t i = 0; i < allocator_.size(); ++i) {
+        const double hi = wheelInertias_[i] * actState.wheelSpeeds[i] * RPM_TO_RADS;
+        const Vec3 a = allocator_.axis(i);
+        h[0] += hi * a[0];
+        h[1] += hi * a[1];
+        h[2] += hi * a[2];
+    }
+    return h;
+}
+
+void ReactionWheelActuator::wheelSpeedsAt(double t, const ActuatorState &actState, double *out) const {
+    const double dt = (actState.lastTime < 0.0) ? 0.0 : (t - actState.lastTime);
+    const double *speeds = actState.wheelSpeeds.data();
+    const double *u = actState.wheelTorques.data();
+    const double *rate = speedRate_.data();
+    const double *maxSpeed = maxSpeedRPM_.data();
+    for (size_t i = 0; i < allocator_.size(); ++i) {
+        const double speed = speeds[i] - rate[i] * u[i] * dt;
+        // applyCommand sizes a limited torque to reach the limit at the end
+        // of the hold; this only absorbs the rounding past it
+        const bool outward = std::abs(speed) > std::abs(speeds[i]);
+        out[i] = (outward && std::abs(speed) > maxSpeed[i]) ? std::copysign(maxSpeed[i], speed) : speed;
     }
 }
 
 Vec3 ReactionWheelActuator::applyCommand(
     double t,
     const AttitudeState &state,
-    const Vec3 &command
+    const Vec3 &command,
+    ActuatorState &actState
 ) const {
     (void)state;  // not used currently
 
-    // Compute time step (first call uses dt=0)
-    double dt = (lastTime_ < 0.0) ? 0.0 : (t - lastTime_);
-    lastTime_ = t;
-
-    // Project commanded torque onto each wheel axis to get per-wheel torque commands
-    // Then apply saturation and speed limits
-    Vec3 appliedTorque = {0.0, 0.0, 0.0};
-
-    for (size_t i = 0; i < wheelAxes_.size(); ++i) {
-        const Vec3& axis = wheelAxes_[i];
-
-        // Project commanded torque onto this wheel's axis
-        double cmdTorqueWheel = (command[0]*axis[0] + command[1]*axis[1] + command[2]*axis[2]);
-
-        // Apply torque saturation
-        double saturatedTorque = std::clamp(cmdTorqueWheel, -maxTorque_[i], maxTorque_[i]);
+    const size_t n = allocator_.size();
+    double *speeds = actState.wheelSpeeds.data();
+    double *u = actState.wheelTorques.data();
+
+    // Advance the wheel speeds over the interval since the last call with
+    // the torque held over it: Omega_dot = -u / I
+    wheelSpeedsAt(t, actState, speeds);
+    actState.lastTime = t;
+
+    // 1. Minimum-norm wheel torques realizing the command, saturated
+    //    without changing the direction of the body torque
+    allocator_.allocate(command, u);
+    allocator_.saturate(u, invMaxTorque_.data());
+
+    // 2. Null-space momentum management: pull wheel momenta toward the
+    //    targets along directions that produce no body torque, within the
+    //    torque the command leaves unused
+    if (nullSpaceGain_ > 0.0) {
+        double *v = actState.nullSpaceTorques.data();
+        for (size_t i = 0; i < n; ++i) {
+            v[i] = wheelInertias_[i] * (speeds[i] - targetSpeeds_[i]) * RPM_TO_RADS;
+        }
+        allocator_.nullSpaceCorrection(v, nullSpaceGain_, v);
+        allocator_.addWithinLimits(u, v, maxTorque_.data());
+    }
 
-        // Update wheel speed: tau = I * alpha => alpha = tau / I
-        // omega_new = omega_old + alpha * dt
-        if (dt > 0.0 && wheelInertias_[i] > 1e-12) {
-            double alphaRads = saturatedTorque / wheelInertias_[i];  // rad/s²
-            double deltaSpeedRPM = alphaRads * RADS_TO_RPM * dt;
-            wheelSpeeds_[i] += deltaSpeedRPM;
+    // 3. Speed limit: a wheel at its limit cannot be spun further
+    //    (its speed changes as -u, so that is u of the opposite sign)
+    const double *maxSpeed = maxSpeedRPM_.data();
+    for (size_t i = 0; i < n; ++i) {
+        const bool atLimit = std::abs(speeds[i]) >= maxSpeed[i];
+        u[i] = (atLimit && speeds[i] * u[i] < 0.0) ? 0.0 : u[i];
+    }
 
-            // Apply speed saturation
-            wheelSpeeds_[i] = std::clamp(wheelSpeeds_[i], -maxSpeedRPM_[i], maxSpeedRPM_[i]);
+    // 4. ... nor spun past it before the next call: a wheel that would
+    //    cross its limit within the hold gets the torque that reaches it
+    //    exactly at the end, so the held torque (and the body torque
+    //    returned, which the dynamics integrate) never overshoots
+    const double hold = actState.holdUntil - t;
+    if (hold > 0.0) {
+        const double *rate = speedRate_.data();
+        for (size_t i = 0; i < n; ++i) {
+            const double end = speeds[i] - rate[i] * u[i] * hold;
+            if (std::abs(end) <= maxSpeed[i] || std::abs(end) <= std::abs(speeds[i])) {
+                continue;
+            }
+            const double limit = std::copysign(maxSpeed[i], end);
+            double ui = (speeds[i] - limit) / (rate[i] * hold);
+            // Round toward the limit so wheelSpeedsAt(holdUntil) reaches it
+            // and a speed limit event sees the crossing
+            while (std::abs(speeds[i] - rate[i] * ui * hold) < maxSpeed[i]) {
+                ui = std::nextafter(ui, u[i]);
+            }
+            u[i] = ui;
         }
-
-        // The reaction torque on the spacecraft is opposite to the wheel torque
-        // tau_spacecraft = -tau_wheel (along axis)
-        appliedTorque[0] += saturatedTorque * axis[0];
-        appliedTorque[1] += saturatedTorque * axis[1];
-        appliedTorque[2] += saturatedTorque * axis[2];
     }
 
-    return appliedTorque;
+    return allocator_.bodyTorque(u);
 }
 
 } // namespace starSense
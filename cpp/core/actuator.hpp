@@ -1,72 +1,142 @@
 #pragma once
 
 #include "types.hpp"
+#include "wheelAllocator.hpp"
 #include <vector>
 #include <cmath>
 
 namespace starSense {
 
+// Per-run actuator state.
+// Owned by the simulation run rather than the actuator, so one configured
+// actuator can be used by many runs back-to-back or concurrently.
+struct ActuatorState {
+    std::vector<double> wheelSpeeds;  // wheel speeds at lastTime [RPM] (empty if no wheels)
+    double lastTime = -1.0;           // time of previous applyCommand call (< 0: none yet)
+    double holdUntil = -1.0;          // time of the next applyCommand call, set by the caller
+                                      // before each one (<= t: unknown, no look-ahead)
+
+    // Per-wheel buffers, sized once in initialState() so applyCommand does
+    // not allocate
+    std::vector<double> wheelTorques;         // torque on the body along each axis, held since lastTime [N·m]
+    std::vector<double> nullSpaceTorques;     // momentum management work buffer [N·m]
+};
+
 // Abstract actuator interface.
 // Takes a commanded body-frame torque and returns the actual applied torque.
 class Actuator {
 public:
     virtual ~Actuator() = default;
 
+    // Fresh per-run state at t = 0
+    virtual ActuatorState initialState() const { return ActuatorState{}; }
+
+    // Angular momentum of the actuator's rotors in the body frame [N·m·s].
+    // The simulation adds it to the rotor momentum h of the initial state.
+    virtual Vec3 rotorMomentum(const ActuatorState &actState) const {
+        (void)actState;
+        return Vec3{0.0, 0.0, 0.0};
+    }
+
+    // Number of reaction wheels (0: none)
+    virtual std::size_t numWheels() const { return 0; }
+
+    // Wheel speeds [RPM] at time t, at or after the last applyCommand call,
+    // written to out[0 .. numWheels())
+    virtual void wheelSpeedsAt(double t, const ActuatorState &actState, double *out) const {
+        (void)t;
+        (void)actState;
+        (void)out;
+    }
+
     // t         : current simulation time [s]
     // state     : current attitude state (q, w)
     // command   : commanded torque in body frame [N·m]
+    // actState  : per-run actuator state, updated in place
     // returns   : applied torque in body frame [N·m]
     virtual Vec3 applyCommand(
         double t,
         const AttitudeState &state,
-        const Vec3 &command
+        const Vec3 &command,
+        ActuatorState &actState
     ) const = 0;
 };
 
 
 // Release 1: ideal actuator (no saturation, no dynamics, no noise)
-class IdealTorqueActuator : public Actuator {
+class IdealTorqueActuator final : public Actuator {
 public:
     Vec3 applyCommand(
         double t,
         const AttitudeState &state,
-        const Vec3 &command
+        const Vec3 &command,
+        ActuatorState &actState
     ) const override;
 };
 
 
-// Reaction wheel actuator with saturation limits
-class ReactionWheelActuator : public Actuator {
+// Reaction wheel actuator with saturation limits.
+// The command is distributed over the wheels with the pseudo-inverse of the
+// axis matrix (see WheelAllocator), so non-orthogonal and redundant arrays
+// realize the commanded torque; arrays spanning fewer than three directions
+// realize its least-squares part. With redundant wheels, null-space
+// momentum management optionally steers the wheel speeds toward targets
+// without disturbing the body.
+//
+// The torque is exchanged with the wheels: each wheel's momentum changes by
+// minus its torque on the body. Use with RigidBodyDynamics configured for
+// ControlTorqueSource::Wheels, which integrates the total rotor momentum
+// through every integrator stage. Between calls the torque is held, so the
+// wheel speeds are linear in time and are advanced here in closed form,
+// consistent with the integrated momentum. A wheel at its speed limit gets
+// no torque that would spin it further, and when actState.holdUntil is set,
+// a wheel that would pass its limit before then only gets the torque that
+// brings it to the limit at the end of the hold.
+class ReactionWheelActuator final : public Actuator {
 public:
-    // wheelAxes: spin axis for each wheel in body frame (should be normalized)
+    // wheelAxes: spin axis for each wheel in body frame
     // wheelInertias: moment of inertia about spin axis for each wheel [kg·m²]
     // maxTorque: max torque each wheel can apply [N·m]
     // maxSpeed: max wheel speed [RPM]
     // initialSpeeds: initial wheel speeds [RPM]
+    // nullSpaceGain: momentum management gain [1/s] (0: off)
+    // targetSpeeds: null-space speed targets [RPM] (empty: all zero)
     ReactionWheelActuator(
         const std::vector<Vec3>& wheelAxes,
         const std::vector<double>& wheelInertias,
         const std::vector<double>& maxTorque,
         const std::vector<double>& maxSpeed,
-        const std::vector<double>& initialSpeeds
+        const std::vector<double>& initialSpeeds,
+        double nullSpaceGain = 0.0,
+        const std::vector<double>& targetSpeeds = {}
     );
 
+    // Wheel speeds start at initialSpeeds
+    ActuatorState initialState() const override;
+
+    Vec3 rotorMomentum(const ActuatorState &actState) const override;
+
+    std::size_t numWheels() const override { return allocator_.size(); }
+
+    void wheelSpeedsAt(double t, const ActuatorState &actState, double *out) const override;
+
     Vec3 applyCommand(
         double t,
         const AttitudeState &state,
-        const Vec3 &command
+        const Vec3 &command,
+        ActuatorState &actState
     ) const override;
 
-    // Get current wheel speeds [RPM]
-    const std::vector<double>& getWheelSpeeds() const { return wheelSpeeds_; }
-
 private:
-    std::vector<Vec3> wheelAxes_;
+    WheelAllocator allocator_;
     std::vector<double> wheelInertias_;
+    std::vector<double> speedRate_;      // RPM/s per N·m of wheel torque (1 / inertia)
     std::vector<double> maxTorque_;
+    std::vector<double> invMaxTorque_;   // 1 / maxTorque, for the saturation step
     std::vector<double> maxSpeedRPM_;
-    mutable std::vector<double> wheelSpeeds_;  // mutable for const applyCommand
-    mutable double lastTime_;
+    std::vector<double> initialSpeeds_;  // [RPM]
+    double nullSpaceGain_;
+    std::vector<double> targetSpeeds_;   // [RPM]
 
     static constexpr double RPM_TO_RADS = M_PI / 30.0;
     static constexpr double RADS_TO_RPM = 30.0 / M_PI;
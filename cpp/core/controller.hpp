@@ -5,69 +5,76 @@
 
 namespace starSense {
 
+// Per-run controller state.
+// Owned by the simulation run rather than the controller, so one configured
+// controller can drive many runs back-to-back or concurrently. The built-in
+// control laws are memoryless: when they run, and holding their output in
+// between, is up to the simulation's MultiRateScheduler.
+struct ControllerState { };
+
 // Abstract controller interface
 class Controller {
 public:
     virtual ~Controller() = default;
 
-    // Compute commanded body-frame torque [N·m]
+    // Compute commanded body-frame torque [N·m]. Called only on the ticks
+    // the controller task is due.
     //  t              : current simulation time [s]
     //  estimatedState : estimated attitude state (q, w)
     //  reference      : desired attitude profile (qRef, wRef)
+    //  state          : per-run state, updated in place
     virtual Vec3 computeCommandTorque(
         double t,
         const AttitudeState &estimatedState,
-        const ReferenceState ref
+        const ReferenceState ref,
+        ControllerState &state
     ) const = 0;
 };
 
 
 // Zero controller
-class ZeroController : public Controller {
+class ZeroController final : public Controller {
 public:
     Vec3 computeCommandTorque(
         double t,
         const AttitudeState &estimatedState,
-        const ReferenceState ref
+        const ReferenceState ref,
+        ControllerState &state
     ) const override;
 };
 
 
 // PD controller
-class PDController : public Controller {
+class PDController final : public Controller {
 public:
-    PDController(Vec3 kpAtt, Vec3 kdRate, double controlRateHz);
+    PDController(Vec3 kpAtt, Vec3 kdRate);
 
     Vec3 computeCommandTorque(
         double t,
         const AttitudeState &estimatedState,
-        const ReferenceState ref
+        const ReferenceState ref,
+        ControllerState &state
     ) const override;
 
 private:
     Vec3 kpAtt_;                              // attitude gain
     Vec3 kdRate_;                             // rate damping gain
-    double controlRateHz_;                    // how often to update control command
-    mutable double nextUpdateTime_ = 0.0;     // next time to refresh torque
-    mutable Vec3 lastTorque_{0.0, 0.0, 0.0};  // held command between updates};
 };
 
 // Linear Quadratic Regulator (LQR) controller
-class LQRController : public Controller {
+class LQRController final : public Controller {
 public:
-    LQRController(const Mat3x6 &K, double controlRateHz);
+    explicit LQRController(const Mat3x6 &K);
 
     Vec3 computeCommandTorque(
         double t,
         const AttitudeState &estimatedState,
-        const ReferenceState ref
+        const ReferenceState ref,
+        ControllerState &state
     ) const override;
 
 private:
     Mat3x6 K_;                                // 3x6 gain matrix passes in from Python
-    double controlRateHz_;                    // how often to update control command
-    mutable double nextUpdateTime_ = 0.0;     // next time to refresh torque
-    mutable Vec3 lastTorque_{0.0, 0.0, 0.0};  // held command between updates};
 };
 
 } // namespace starSense
@@ -0,0 +1,321 @@
+#include "dispersion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace starSense {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+} // namespace
+
+// ----------------------------------------------------------
+// RunningMoments
+// ----------------------------------------------------------
+
+void RunningMoments::merge(const RunningMoments &other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    const double n1 = static_cast<double>(count_);
+    const double n2 = static_cast<double>(other.count_);
+    const double n = n1 + n2;
+    const double delta = other.mean_ - mean_;
+    mean_ += delta * n2 / n;
+    m2_ += other.m2_ + delta * delta * n1 * n2 / n;
+    count_ += other.count_;
+}
+
+double RunningMoments::stddev() const {
+    return std::sqrt(variance());
+}
+
+// ----------------------------------------------------------
+// TDigest
+// ----------------------------------------------------------
+
+TDigest::TDigest(double compression)
+    : compression_(compression),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity())
+{
+    if (!(compression > 1.0)) {
+        throw std::invalid_argument("TDigest: compression must be > 1");
+    }
+}
+
+void TDigest::add(double x) {
+    buffer_.push_back(x);
+    min_ = std::min(min_, x);
+    max_ = std::max(max_, x);
+    if (static_cast<double>(buffer_.size()) >= compression_) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest &other) {
+    centroids_.insert(centroids_.end(), other.centroids_.begin(), other.centroids_.end());
+    totalWeight_ += other.totalWeight_;
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    rebuild_();
+}
+
+void TDigest::compress() {
+    if (!buffer_.empty()) {
+        rebuild_();
+    }
+}
+
+void TDigest::rebuild_() {
+    std::vector<Centroid> all;
+    all.reserve(centroids_.size() + buffer_.size());
+    all.insert(all.end(), centroids_.begin(), centroids_.end());
+    for (double x : buffer_) {
+        all.push_back(Centroid{x, 1.0});
+    }
+    buffer_.clear();
+    if (all.empty()) {
+        return;
+    }
+    std::sort(all.begin(), all.end(),
+        [](const Centroid &a, const Centroid &b) { return a.mean < b.mean; });
+
+    double total = 0.0;
+    for (const Centroid &c : all) {
+        total += c.weight;
+    }
+
+    // k1 scale: k(q) = delta / (2 pi) asin(2q - 1). A centroid may grow
+    // while it spans at most one unit of k, which keeps the tails fine.
+    const double delta = compression_;
+    auto kScale = [delta](double q) {
+        return delta / kTwoPi * std::asin(std::clamp(2.0 * q - 1.0, -1.0, 1.0));
+    };
+    auto kInverse = [delta](double k) {
+        return 0.5 * (std::sin(std::min(k, 0.25 * delta) * kTwoPi / delta) + 1.0);
+    };
+
+    centroids_.clear();
+    double weightSoFar = 0.0;
+    double weightLimit = total * kInverse(kScale(0.0) + 1.0);
+    Centroid current = all.front();
+    for (std::size_t i = 1; i < all.size(); ++i) {
+        const Centroid &c = all[i];
+        if (weightSoFar + current.weight + c.weight <= weightLimit) {
+            current.weight += c.weight;
+            current.mean += (c.mean - current.mean) * c.weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            centroids_.push_back(current);
+            weightLimit = total * kInverse(kScale(weightSoFar / total) + 1.0);
+            current = c;
+        }
+    }
+    centroids_.push_back(current);
+    totalWeight_ = total;
+}
+
+double TDigest::quantile(double q) const {
+    if (centroids_.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (centroids_.size() == 1) {
+        return centroids_.front().mean;
+    }
+
+    // Centroid i sits at cumulative weight (weight before it) + w_i / 2;
+    // interpolate linearly between those points, and towards min / max
+    // beyond the first and last
+    const double target = std::clamp(q, 0.0, 1.0) * totalWeight_;
+    const Centroid &first = centroids_.front();
+    const Centroid &last = centroids_.back();
+    if (target < 0.5 * first.weight) {
+        return min_ + (first.mean - min_) * target / (0.5 * first.weight);
+    }
+    if (target > totalWeight_ - 0.5 * last.weight) {
+        const double span = 0.5 * last.weight;
+        return max_ - (max_ - last.mean) * (totalWeight_ - target) / span;
+    }
+
+    double center = 0.5 * first.weight;
+    for (std::size_t i = 0; i + 1 < centroids_.size(); ++i) {
+        const Centroid &a = centroids_[i];
+        const Centroid &b = centroids_[i + 1];
+        const double nextCenter = center + 0.5 * (a.weight + b.weight);
+        if (target <= nextCenter) {
+            const double f = (target - center) / (nextCenter - center);
+            return a.mean + f * (b.mean - a.mean);
+        }
+        center = nextCenter;
+    }
+    return last.mean;
+}
+
+// ----------------------------------------------------------
+// DispersionStatistics
+// ----------------------------------------------------------
+
+const ChannelEnvelope &DispersionStatistics::channel(const std::string &name) const {
+    for (const ChannelEnvelope &c : channels) {
+        if (c.name == name) {
+            return c;
+        }
+    }
+    throw std::out_of_range("DispersionStatistics: no channel '" + name + "'");
+}
+
+// ----------------------------------------------------------
+// DispersionAccumulator
+// ----------------------------------------------------------
+
+DispersionAccumulator::DispersionAccumulator(const DispersionConfig &config, const ChannelLayout &layout)
+    : config_(config)
+{
+    if (!(config_.binWidth > 0.0) || config_.numBins == 0) {
+        throw std::invalid_argument("DispersionAccumulator: binWidth must be > 0 and numBins >= 1");
+    }
+    for (double q : config_.quantiles) {
+        if (!(q >= 0.0 && q <= 1.0)) {
+            throw std::invalid_argument("DispersionAccumulator: quantiles must lie in [0, 1]");
+        }
+    }
+
+    // Channel widths come from SimulationResult itself
+    SimulationResult columns;
+    columns.setLayout(layout);
+    for (const std::string &name : config_.channels) {
+        bool found = false;
+        columns.forEachChannel([&](const char *channelName, const auto &channel, bool) {
+            if (!found && name == channelName) {
+                slots_.push_back(Slot{name, channelWidth(channel), stride_});
+                stride_ += channelWidth(channel);
+                found = true;
+            }
+        });
+        if (!found) {
+            throw std::invalid_argument("DispersionAccumulator: unknown channel '" + name + "'");
+        }
+    }
+
+    moments_.resize(config_.numBins * stride_);
+    digests_.assign(config_.numBins * stride_, TDigest(config_.compression));
+}
+
+std::size_t DispersionAccumulator::binOf(double t) const {
+    const double b = std::floor(t / config_.binWidth + 0.5);
+    if (!(b >= 0.0) || b >= static_cast<double>(config_.numBins)) {
+        return config_.numBins;
+    }
+    return static_cast<std::size_t>(b);
+}
+
+void DispersionAccumulator::addChunk(const SimulationResult &chunk) {
+    bins_.resize(chunk.time.size());
+    for (std::size_t r = 0; r < chunk.time.size(); ++r) {
+        bins_[r] = binOf(chunk.time[r]);
+    }
+
+    chunk.forEachChannel([&](const char *name, const auto &channel, bool) {
+        for (const Slot &slot : slots_) {
+            if (slot.name != name) {
+                continue;
+            }
+            const std::size_t width = channelWidth(channel);
+            if (width != slot.width) {
+                throw std::invalid_argument(
+                    "DispersionAccumulator: channel '" + slot.name + "' has " + std::to_string(width) +
+                    " columns, expected " + std::to_string(slot.width));
+            }
+            // Per-interval channels have one row fewer than time
+            const double *data = channelData(channel);
+            const std::size_t rows = std::min(channel.size(), bins_.size());
+            for (std::size_t r = 0; r < rows; ++r) {
+                if (bins_[r] >= config_.numBins) {
+                    continue;
+                }
+                const std::size_t base = bins_[r] * stride_ + slot.offset;
+                for (std::size_t j = 0; j < width; ++j) {
+                    const double x = data[r * width + j];
+                    moments_[base + j].add(x);
+                    digests_[base + j].add(x);
+                }
+            }
+        }
+    });
+}
+
+void DispersionAccumulator::merge(const DispersionAccumulator &other) {
+    if (other.stride_ != stride_ || other.config_.numBins != config_.numBins) {
+        throw std::invalid_argument("DispersionAccumulator: cannot merge accumulators of different configs");
+    }
+    for (std::size_t i = 0; i < moments_.size(); ++i) {
+        moments_[i].merge(other.moments_[i]);
+        digests_[i].merge(other.digests_[i]);
+    }
+    runs_ += other.runs_;
+}
+
+DispersionStatistics DispersionAccumulator::statistics() {
+    const std::size_t numBins = config_.numBins;
+    const std::size_t numQuantiles = config_.quantiles.size();
+
+    DispersionStatistics out;
+    out.runs = runs_;
+    out.quantiles = config_.quantiles;
+    out.time.resize(numBins);
+    for (std::size_t b = 0; b < numBins; ++b) {
+        out.time[b] = static_cast<double>(b) * config_.binWidth;
+    }
+
+    for (TDigest &digest : digests_) {
+        digest.compress();
+    }
+
+    for (const Slot &slot : slots_) {
+        ChannelEnvelope env;
+        env.name = slot.name;
+        env.width = slot.width;
+        env.count.resize(numBins);
+        env.mean.width = slot.width;
+        env.stddev.width = slot.width;
+        env.quantiles.resize(numQuantiles);
+        for (DynamicSeries &series : env.quantiles) {
+            series.width = slot.width;
+            series.reserve(numBins);
+        }
+        env.mean.reserve(numBins);
+        env.stddev.reserve(numBins);
+
+        for (std::size_t b = 0; b < numBins; ++b) {
+            const std::size_t base = b * stride_ + slot.offset;
+            env.count[b] = moments_[base].count();
+            double *mean = env.mean.appendRow();
+            double *stddev = env.stddev.appendRow();
+            for (std::size_t j = 0; j < slot.width; ++j) {
+                const bool empty = moments_[base + j].count() == 0;
+                mean[j] = empty ? std::numeric_limits<double>::quiet_NaN() : moments_[base + j].mean();
+                stddev[j] = empty ? std::numeric_limits<double>::quiet_NaN() : moments_[base + j].stddev();
+            }
+            for (std::size_t k = 0; k < numQuantiles; ++k) {
+                double *row = env.quantiles[k].appendRow();
+                for (std::size_t j = 0; j < slot.width; ++j) {
+                    row[j] = digests_[base + j].quantile(config_.quantiles[k]);
+                }
+            }
+        }
+        out.channels.push_back(std::move(env));
+    }
+    return out;
+}
+
+} // namespace starSense
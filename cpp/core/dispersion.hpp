@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Monte Carlo dispersion statistics
+//
+// Time-aligned envelopes (mean, standard deviation, quantiles) of logged
+// channels across many runs, built without keeping any run's history:
+// each logged chunk is folded into per-time-bin accumulators as it streams
+// out of the run. Moments use Welford's update and quantiles a merging
+// t-digest, both of which merge exactly (moments) or within the sketch's
+// accuracy (quantiles), so every worker thread keeps its own accumulators
+// and they are combined once at the end. Memory depends on the number of
+// bins and channels, not on the number of runs. Quantile estimates depend
+// slightly on the order in which values are merged, and so on scheduling.
+// ----------------------------------------------------------
+
+// Running count, mean and variance (Welford), mergeable (Chan et al.)
+class RunningMoments {
+public:
+    void add(double x) {
+        ++count_;
+        const double delta = x - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (x - mean_);
+    }
+
+    void merge(const RunningMoments &other);
+
+    std::size_t count() const { return count_; }
+    double mean() const { return mean_; }
+
+    // Sample variance (n - 1 denominator; 0 for fewer than two values)
+    double variance() const {
+        return (count_ > 1) ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+    }
+
+    double stddev() const;
+
+private:
+    std::size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+// Merging t-digest (Dunning & Ertl, "Computing extremely accurate quantiles
+// using t-digests", 2019) with the k1 scale function: a sorted list of at
+// most ~compression centroids, finest at the tails, so extreme quantiles
+// (1st / 99th percentile) stay accurate. Values are buffered and folded in
+// when the buffer fills.
+class TDigest {
+public:
+    explicit TDigest(double compression = 100.0);
+
+    void add(double x);
+    void merge(const TDigest &other);
+
+    // Fold the buffer into the centroids
+    void compress();
+
+    double count() const { return totalWeight_ + static_cast<double>(buffer_.size()); }
+
+    // Estimate of the q-quantile, q in [0, 1] (NaN when empty). Call
+    // compress() first; buffered values are otherwise ignored.
+    double quantile(double q) const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Sort centroids and buffer together and re-merge them under the scale
+    // function's size limit
+    void rebuild_();
+
+    double compression_;
+    std::vector<Centroid> centroids_;  // sorted by mean
+    std::vector<double> buffer_;       // unit-weight values not yet folded in
+    double totalWeight_ = 0.0;         // weight in centroids_
+    double min_;
+    double max_;
+};
+
+// Bin count runDispersionBatch uses when it picks the bins itself: long or
+// finely logged runs are merged into this many bins rather than one per sample
+constexpr std::size_t kDefaultDispersionBins = 1000;
+
+// What to accumulate
+struct DispersionConfig {
+    // Channels by SimulationResult::forEachChannel name
+    std::vector<std::string> channels = {"quats", "omegas", "attitudeError", "rateError"};
+    std::vector<double> quantiles = {0.01, 0.5, 0.99};
+    double binWidth = 0.0;        // [s]; bin b collects samples with t in [(b - 1/2), (b + 1/2)) * binWidth
+    std::size_t numBins = 0;      // bins past the last are dropped
+    double compression = 100.0;   // t-digest size / accuracy trade-off
+};
+
+// Envelope of one channel: every series has one row per bin and one column
+// per channel component
+struct ChannelEnvelope {
+    std::string name;
+    std::size_t width = 0;
+    std::vector<std::size_t> count;        // samples folded into each bin
+    DynamicSeries mean;
+    DynamicSeries stddev;                  // sample standard deviation
+    std::vector<DynamicSeries> quantiles;  // one per DispersionConfig::quantiles
+};
+
+struct DispersionStatistics {
+    std::vector<double> time;       // bin centres b * binWidth [s]
+    std::vector<double> quantiles;  // levels of ChannelEnvelope::quantiles
+    std::vector<ChannelEnvelope> channels;
+    std::size_t runs = 0;
+
+    // Envelope by channel name (throws std::out_of_range if absent)
+    const ChannelEnvelope &channel(const std::string &name) const;
+};
+
+// Per-bin accumulators for the channels of one DispersionConfig. One per
+// worker thread: addChunk() is not synchronized.
+class DispersionAccumulator {
+public:
+    //  config : channels, quantile levels and bins; every name must be a
+    //           channel of a result with this layout
+    //  layout : optional channels the runs log (sets wheelSpeeds' width)
+    DispersionAccumulator(const DispersionConfig &config, const ChannelLayout &layout = {});
+
+    // Fold in one logged chunk (any number of rows) of a run
+    void addChunk(const SimulationResult &chunk);
+
+    // Count one finished run
+    void runDone() { ++runs_; }
+
+    // Combine with another worker's accumulators for the same config
+    void merge(const DispersionAccumulator &other);
+
+    DispersionStatistics statistics();
+
+private:
+    struct Slot {
+        std::string name;
+        std::size_t width;
+        std::size_t offset;  // first accumulator of bin 0
+    };
+
+    // Index of the bin holding time t (numBins if outside)
+    std::size_t binOf(double t) const;
+
+    DispersionConfig config_;
+    std::vector<Slot> slots_;
+    std::size_t stride_ = 0;                // accumulators per bin
+    std::vector<RunningMoments> moments_;   // [bin * stride_ + offset + component]
+    std::vector<TDigest> digests_;          // same indexing
+    std::vector<std::size_t> bins_;         // scratch: bin of each chunk row
+    std::size_t runs_ = 0;
+};
+
+} // namespace starSense
@@ -0,0 +1,218 @@
+#include "disturbance.hpp"
+
+#include <utility>
+#include <stdexcept>
+
+namespace starSense {
+
+namespace {
+
+constexpr double kSolarPressure = 4.56e-6;           // at 1 AU [N/m²]
+constexpr double kObliquity = 0.4090877;              // 23.439° [rad]
+constexpr double kSiderealYear = 31558149.8;          // [s]
+constexpr double kDipoleField = 3.0e-5;               // equatorial surface field [T]
+constexpr double kDipoleColatitude = 0.1642;          // north geomagnetic pole, 9.41° [rad]
+constexpr double kDipoleLongitude = -1.2678;          // -72.64° [rad]
+
+// Piecewise exponential atmosphere: base altitude [km], base density
+// [kg/m³], scale height [km]
+struct DensityBand {
+    double h0;
+    double rho0;
+    double scaleHeight;
+};
+
+constexpr DensityBand kDensityBands[] = {
+    {0.0, 1.225, 7.249},        {25.0, 3.899e-2, 6.349},    {30.0, 1.774e-2, 6.682},
+    {40.0, 3.972e-3, 7.554},    {50.0, 1.057e-3, 8.382},    {60.0, 3.206e-4, 7.714},
+    {70.0, 8.770e-5, 6.549},    {80.0, 1.905e-5, 5.799},    {90.0, 3.396e-6, 5.382},
+    {100.0, 5.297e-7, 5.877},   {110.0, 9.661e-8, 7.263},   {120.0, 2.438e-8, 9.473},
+    {130.0, 8.484e-9, 12.636},  {140.0, 3.845e-9, 16.149},  {150.0, 2.070e-9, 22.523},
+    {180.0, 5.464e-10, 29.740}, {200.0, 2.789e-10, 37.105}, {250.0, 7.248e-11, 45.546},
+    {300.0, 2.418e-11, 53.628}, {350.0, 9.518e-12, 53.298}, {400.0, 3.725e-12, 58.515},
+    {450.0, 1.585e-12, 60.828}, {500.0, 6.967e-13, 63.822}, {600.0, 1.454e-13, 71.835},
+    {700.0, 3.614e-14, 88.667}, {800.0, 1.170e-14, 124.64}, {900.0, 5.245e-15, 181.05},
+    {1000.0, 3.019e-15, 268.00}
+};
+
+Vec3 scaled(const Vec3 &v, double s) {
+    return Vec3{s * v[0], s * v[1], s * v[2]};
+}
+
+double norm(const Vec3 &v) {
+    return std::sqrt(dot(v, v));
+}
+
+// Rotation matrix taking inertial vectors to the body frame for the
+// attitude q (body wrt inertial); built once per torque evaluation and
+// applied to every environment vector
+Mat3 bodyFromInertial(const Quat &q) {
+    const double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    return Mat3{{
+        {{q0*q0 + q1*q1 - q2*q2 - q3*q3, 2.0 * (q1*q2 + q0*q3), 2.0 * (q1*q3 - q0*q2)}},
+        {{2.0 * (q1*q2 - q0*q3), q0*q0 - q1*q1 + q2*q2 - q3*q3, 2.0 * (q2*q3 + q0*q1)}},
+        {{2.0 * (q1*q3 + q0*q2), 2.0 * (q2*q3 - q0*q1), q0*q0 - q1*q1 - q2*q2 + q3*q3}}
+    }};
+}
+
+} // namespace
+
+double atmosphericDensity(double altitude) {
+    const double hKm = altitude * 1e-3;
+    if (hKm < 0.0) {
+        return kDensityBands[0].rho0;
+    }
+    const DensityBand *band = &kDensityBands[0];
+    for (const DensityBand &b : kDensityBands) {
+        if (hKm >= b.h0) {
+            band = &b;
+        }
+    }
+    return band->rho0 * std::exp(-(hKm - band->h0) / band->scaleHeight);
+}
+
+Vec3 sunDirection(double t, double sunLongitude0) {
+    const double lambda = sunLongitude0 + 2.0 * M_PI * t / kSiderealYear;
+    const double cl = std::cos(lambda);
+    const double sl = std::sin(lambda);
+    return Vec3{cl, std::cos(kObliquity) * sl, std::sin(kObliquity) * sl};
+}
+
+double illumination(const Vec3 &r, const Vec3 &sunDir) {
+    const double along = dot(r, sunDir);
+    if (along >= 0.0) {
+        return 1.0;
+    }
+    const Vec3 perp = sub(r, scaled(sunDir, along));
+    return (dot(perp, perp) < kEarthRadius * kEarthRadius) ? 0.0 : 1.0;
+}
+
+Vec3 geomagneticField(double t, const Vec3 &r) {
+    // Dipole moment points to the south geomagnetic pole
+    const double lon = kDipoleLongitude + kEarthRotationRate * t;
+    const double sc = std::sin(kDipoleColatitude);
+    const Vec3 m{-sc * std::cos(lon), -sc * std::sin(lon), -std::cos(kDipoleColatitude)};
+
+    // B = B0 (Re/|r|)³ [3 (m·r̂) r̂ - m]
+    const double rNorm = norm(r);
+    const Vec3 rHat = scaled(r, 1.0 / rNorm);
+    const double ratio = kEarthRadius / rNorm;
+    const double b0 = kDipoleField * ratio * ratio * ratio;
+    return scaled(sub(scaled(rHat, 3.0 * dot(m, rHat)), m), b0);
+}
+
+EnvironmentSample evaluateEnvironment(const KeplerOrbit &orbit, double t, double sunLongitude0) {
+    const OrbitState o = orbit.state(t);
+
+    EnvironmentSample s;
+    s.r = o.r;
+    s.v = o.v;
+    s.sunDir = sunDirection(t, sunLongitude0);
+    s.illumination = illumination(o.r, s.sunDir);
+    s.density = atmosphericDensity(norm(o.r) - kEarthRadius);
+    s.magField = geomagneticField(t, o.r);
+    return s;
+}
+
+
+// EnvironmentTable
+EnvironmentTable::EnvironmentTable(
+    const KeplerOrbit &orbit,
+    double sunLongitude0,
+    double tEnd,
+    double updateInterval
+)
+    : interval_(updateInterval),
+      invInterval_(1.0 / updateInterval)
+{
+    if (!(updateInterval > 0.0) || !(tEnd >= 0.0)) {
+        throw std::invalid_argument(
+            "EnvironmentTable: updateInterval must be > 0 and tEnd >= 0");
+    }
+
+    // At least two samples, and one past tEnd so the last interval is
+    // interpolated rather than extrapolated
+    const std::size_t count = static_cast<std::size_t>(std::ceil(tEnd * invInterval_)) + 2;
+    samples_.reserve(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        samples_.push_back(evaluateEnvironment(orbit, static_cast<double>(k) * interval_, sunLongitude0));
+    }
+}
+
+EnvironmentSample EnvironmentTable::at(double t) const {
+    // Interval [t_k, t_k+1] holding t, clamped to the table (stray stage
+    // times just outside it extrapolate from the end intervals)
+    const double u = t * invInterval_;
+    const double kMax = static_cast<double>(samples_.size() - 2);
+    const double kf = std::min(std::max(std::floor(u), 0.0), kMax);
+    const std::size_t k = static_cast<std::size_t>(kf);
+    const double f = u - kf;
+    const EnvironmentSample &a = samples_[k];
+    const EnvironmentSample &b = samples_[k + 1];
+
+    auto lerp = [f](double x0, double x1) { return x0 + f * (x1 - x0); };
+
+    // Cubic Hermite basis, tangents scaled by the interval
+    const double f2 = f * f;
+    const double f3 = f2 * f;
+    const double h00 = 2.0 * f3 - 3.0 * f2 + 1.0;
+    const double h10 = (f3 - 2.0 * f2 + f) * interval_;
+    const double h01 = -2.0 * f3 + 3.0 * f2;
+    const double h11 = (f3 - f2) * interval_;
+
+    EnvironmentSample s;
+    for (std::size_t i = 0; i < 3; ++i) {
+        s.r[i] = h00 * a.r[i] + h10 * a.v[i] + h01 * b.r[i] + h11 * b.v[i];
+        s.v[i] = lerp(a.v[i], b.v[i]);
+        s.sunDir[i] = lerp(a.sunDir[i], b.sunDir[i]);
+        s.magField[i] = lerp(a.magField[i], b.magField[i]);
+    }
+    s.sunDir = normalize(s.sunDir);
+    s.illumination = lerp(a.illumination, b.illumination);
+    s.density = lerp(a.density, b.density);
+    return s;
+}
+
+
+// DisturbanceModel
+DisturbanceModel::DisturbanceModel(const DisturbanceParams &params, EnvironmentTable environment)
+    : params_(params),
+      environment_(std::move(environment))
+{}
+
+Vec3 DisturbanceModel::torque(double t, const AttitudeState &x) const {
+    const EnvironmentSample env = environment_.at(t);
+    const Mat3 C = bodyFromInertial(x.q);
+    Vec3 tau{0.0, 0.0, 0.0};
+
+    if (params_.gravityGradient) {
+        // tau = 3 mu / |r|³ r̂_b × (J r̂_b)
+        const double rNorm = norm(env.r);
+        const Vec3 rHat = matmul(C, scaled(env.r, 1.0 / rNorm));
+        const double k = 3.0 * kEarthMu / (rNorm * rNorm * rNorm);
+        tau = add(tau, scaled(cross(rHat, matmul(params_.inertia, rHat)), k));
+    }
+
+    if (params_.aeroDrag) {
+        // Velocity relative to an atmosphere co-rotating with the Earth
+        const Vec3 vRel = sub(env.v, cross(Vec3{0.0, 0.0, kEarthRotationRate}, env.r));
+        const Vec3 vBody = matmul(C, vRel);
+        const double q = 0.5 * env.density * params_.dragCoefficient * params_.dragArea * norm(vBody);
+        tau = add(tau, cross(params_.centerOfPressure, scaled(vBody, -q)));
+    }
+
+    if (params_.solarPressure && env.illumination > 0.0) {
+        // Force directed away from the Sun
+        const Vec3 sunBody = matmul(C, env.sunDir);
+        const double p = kSolarPressure * params_.srpReflectivity * params_.srpArea * env.illumination;
+        tau = add(tau, cross(params_.centerOfPressure, scaled(sunBody, -p)));
+    }
+
+    if (params_.magneticDipole) {
+        tau = add(tau, cross(params_.residualDipole, matmul(C, env.magField)));
+    }
+
+    return tau;
+}
+
+} // namespace starSense
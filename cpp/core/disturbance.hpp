@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+
+#include "types.hpp"
+#include "util.hpp"
+#include "orbit.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Environmental disturbance torques
+//
+// The environment (orbit position and velocity, Sun direction, eclipse,
+// atmospheric density, geomagnetic field) depends only on time and varies on
+// orbital time scales, far slower than the attitude. EnvironmentTable
+// evaluates it once per update interval for the whole run and interpolates,
+// so the integrator's derivative evaluations (four per RK4 step) only pay
+// for the attitude-dependent part: rotating a few vectors into the body
+// frame and a handful of cross products.
+// ----------------------------------------------------------
+
+// Slow environment quantities at one time, all in the Earth-centred inertial frame
+struct EnvironmentSample {
+    Vec3 r{0.0, 0.0, 0.0};         // spacecraft position [m]
+    Vec3 v{0.0, 0.0, 0.0};         // spacecraft velocity [m/s]
+    Vec3 sunDir{1.0, 0.0, 0.0};    // unit vector to the Sun
+    double illumination = 1.0;     // 1 in sunlight, 0 in the Earth's shadow
+    double density = 0.0;          // atmospheric density [kg/m³]
+    Vec3 magField{0.0, 0.0, 0.0};  // geomagnetic field [T]
+};
+
+// Exponential atmosphere, piecewise in altitude (Vallado, Table 8-4) [kg/m³]
+double atmosphericDensity(double altitude);
+
+// Low-precision Sun direction: circular Earth orbit, sunLongitude0 is the
+// Sun's ecliptic longitude at t = 0 (0: March equinox)
+Vec3 sunDirection(double t, double sunLongitude0);
+
+// Cylindrical Earth shadow: 0 in umbra, 1 otherwise
+double illumination(const Vec3 &r, const Vec3 &sunDir);
+
+// Tilted dipole geomagnetic field, rotating with the Earth (Greenwich on
+// the inertial x axis at t = 0) [T]
+Vec3 geomagneticField(double t, const Vec3 &r);
+
+EnvironmentSample evaluateEnvironment(const KeplerOrbit &orbit, double t, double sunLongitude0);
+
+// Environment sampled on t_k = k * updateInterval over [0, tEnd] and
+// interpolated in between: cubic Hermite for position (using the sampled
+// velocity), linear for everything else. Immutable after construction, so
+// one table can be shared by concurrent runs.
+class EnvironmentTable {
+public:
+    EnvironmentTable(const KeplerOrbit &orbit, double sunLongitude0, double tEnd, double updateInterval);
+
+    EnvironmentSample at(double t) const;
+
+    std::size_t size() const { return samples_.size(); }
+
+private:
+    double interval_;
+    double invInterval_;
+    std::vector<EnvironmentSample> samples_;
+};
+
+// Which disturbances act on the spacecraft and its physical properties
+struct DisturbanceParams {
+    bool gravityGradient = false;
+    bool aeroDrag = false;
+    bool solarPressure = false;
+    bool magneticDipole = false;
+
+    Mat3 inertia{};                         // body inertia [kg·m²] (gravity gradient)
+    double dragArea = 1.0;                  // [m²]
+    double dragCoefficient = 2.2;
+    double srpArea = 1.0;                   // [m²]
+    double srpReflectivity = 1.3;           // C_r: 1 absorbing, 2 mirror
+    Vec3 centerOfPressure{0.0, 0.0, 0.0};   // from the centre of mass, body frame [m]
+    Vec3 residualDipole{0.0, 0.0, 0.0};     // body frame [A·m²]
+};
+
+// Sum of the enabled disturbance torques, in the body frame. Drag and solar
+// pressure use a single effective area acting at the centre of pressure.
+class DisturbanceModel {
+public:
+    DisturbanceModel(const DisturbanceParams &params, EnvironmentTable environment);
+
+    Vec3 torque(double t, const AttitudeState &x) const;
+
+    const EnvironmentTable &environment() const { return environment_; }
+
+private:
+    DisturbanceParams params_;
+    EnvironmentTable environment_;
+};
+
+} // namespace starSense
@@ -1,6 +1,9 @@
 #pragma once
+#include <memory>
+
 #include "types.hpp"
 #include "util.hpp"
+#include "disturbance.hpp"
 
 namespace starSense {
 
@@ -17,7 +20,7 @@ public:
 };
 
 // kinematic-only / free-omega dynamics (w_dot = 0)
-class KinematicDynamics : public AttitudeDynamics {
+class KinematicDynamics final : public AttitudeDynamics {
 public:
     AttitudeState computeDerivative(
         double t,
@@ -26,10 +29,24 @@ public:
     ) const override;
 };
 
-// rigid-body with inertia, real w_dot
-class RigidBodyDynamics : public AttitudeDynamics {
+// How the actuator torque passed as tauBody acts on the spacecraft
+enum class ControlTorqueSource {
+    External,  // thrusters, magnetorquers, ideal torque: rotor momentum h is constant
+    Wheels     // momentum exchange with reaction wheels: h_dot = -tauBody
+};
+
+// rigid-body with inertia, real w_dot, as a gyrostat: the rotor momentum h
+// carried in the state couples into the body rates,
+//   J w_dot = tau - w × (J w + h)
+// Optional environmental disturbances are added to tau at every derivative
+// evaluation (they never change h).
+class RigidBodyDynamics final : public AttitudeDynamics {
 public:
-    explicit RigidBodyDynamics(const Mat3& inertiaBody);
+    explicit RigidBodyDynamics(
+        const Mat3& inertiaBody,
+        std::shared_ptr<const DisturbanceModel> disturbances = nullptr,
+        ControlTorqueSource torqueSource = ControlTorqueSource::External
+    );
 
     AttitudeState computeDerivative(
         double t,
@@ -40,6 +57,49 @@ public:
 private:
     Mat3 J_;     // inertia matrix in body frame
     Mat3 Jinv_;  // its inverse
+    std::shared_ptr<const DisturbanceModel> disturbances_;  // shared, immutable
+    ControlTorqueSource torqueSource_;
 };
 
+// Defined here so that statically composed simulations inline it into the
+// integrator stages
+inline
+AttitudeState RigidBodyDynamics::computeDerivative(
+    double t,
+    const AttitudeState& x,
+    const Vec3& tauBody
+) const {
+    const Quat &q = x.q;  // [q0, q1, q2, q3], scalar first
+    const Vec3 &w = x.w;  // [wx, wy, wz] in body frame
+
+    const double wx = w[0];
+    const double wy = w[1];
+    const double wz = w[2];
+
+    AttitudeState xdot;
+
+    // Quaternion kinematics: q_dot = 0.5 * Ω(ω) * q
+    xdot.q[0] = 0.5 * (-wx * q[1] - wy * q[2] - wz * q[3]);
+    xdot.q[1] = 0.5 * ( wx * q[0] + wz * q[2] - wy * q[3]);
+    xdot.q[2] = 0.5 * ( wy * q[0] - wz * q[1] + wx * q[3]);
+    xdot.q[3] = 0.5 * ( wz * q[0] + wy * q[1] - wx * q[2]);
+
+    // Environmental disturbances (the only explicit time dependence)
+    const Vec3 tau = disturbances_ ? add(tauBody, disturbances_->torque(t, x)) : tauBody;
+
+    // Gyrostat dynamics: wdot = J^{-1} ( tau - w × (J w + h) )
+    Vec3 H = add(matmul(J_, x.w), x.h);  // total angular momentum J w + h
+    Vec3 wxH = cross(x.w, H);            // w × (J w + h)
+    Vec3 rhs = sub(tau, wxH);            // RHS = tau - w × (J w + h)
+    Vec3 wdot = matmul(Jinv_, rhs);      // wdot = Jinv * rhs
+    xdot.w = wdot;
+
+    // Wheel torque reacts on the rotors
+    if (torqueSource_ == ControlTorqueSource::Wheels) {
+        xdot.h = Vec3{-tauBody[0], -tauBody[1], -tauBody[2]};
+    }
+
+    return xdot;
+}
+
 } // namespace starSense
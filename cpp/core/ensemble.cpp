@@ -0,0 +1,224 @@
+#include "ensemble.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "parallel.hpp"
+#include "scheduler.hpp"
+#include "util.hpp"
+
+namespace starSense {
+
+namespace {
+
+constexpr std::size_t W = kEnsembleLanes;
+
+// Row-major 3x3 / 3x6 matrices, one value per lane
+using Lanes = double[W];
+
+struct alignas(64) LaneState {
+    Lanes q[4];
+    Lanes w[3];
+};
+
+struct alignas(64) LaneBlock {
+    LaneState x;
+    Lanes J[9];
+    Lanes Jinv[9];
+    Lanes K[18];
+    Lanes qRef[4];
+    Lanes wRef[3];
+    Lanes tau[3];   // held control torque
+};
+
+// xdot = f(x, tau) for every lane (same operation order as RigidBodyDynamics)
+inline void derivative(const LaneBlock &b, const LaneState &x, LaneState &dx) {
+    for (std::size_t l = 0; l < W; ++l) {
+        const double q0 = x.q[0][l], q1 = x.q[1][l], q2 = x.q[2][l], q3 = x.q[3][l];
+        const double wx = x.w[0][l], wy = x.w[1][l], wz = x.w[2][l];
+
+        // Quaternion kinematics: q_dot = 0.5 * Ω(ω) * q
+        dx.q[0][l] = 0.5 * (-wx * q1 - wy * q2 - wz * q3);
+        dx.q[1][l] = 0.5 * ( wx * q0 + wz * q2 - wy * q3);
+        dx.q[2][l] = 0.5 * ( wy * q0 - wz * q1 + wx * q3);
+        dx.q[3][l] = 0.5 * ( wz * q0 + wy * q1 - wx * q2);
+
+        // J * w
+        const double Jw0 = b.J[0][l] * wx + b.J[1][l] * wy + b.J[2][l] * wz;
+        const double Jw1 = b.J[3][l] * wx + b.J[4][l] * wy + b.J[5][l] * wz;
+        const double Jw2 = b.J[6][l] * wx + b.J[7][l] * wy + b.J[8][l] * wz;
+
+        // rhs = tau - w × (J w)
+        const double r0 = b.tau[0][l] - (wy * Jw2 - wz * Jw1);
+        const double r1 = b.tau[1][l] - (wz * Jw0 - wx * Jw2);
+        const double r2 = b.tau[2][l] - (wx * Jw1 - wy * Jw0);
+
+        // wdot = Jinv * rhs
+        dx.w[0][l] = b.Jinv[0][l] * r0 + b.Jinv[1][l] * r1 + b.Jinv[2][l] * r2;
+        dx.w[1][l] = b.Jinv[3][l] * r0 + b.Jinv[4][l] * r1 + b.Jinv[5][l] * r2;
+        dx.w[2][l] = b.Jinv[6][l] * r0 + b.Jinv[7][l] * r1 + b.Jinv[8][l] * r2;
+    }
+}
+
+// tau = -K [e_att; e_w] for every lane (same error definitions as the
+// PD/LQR controllers)
+inline void controlLaw(LaneBlock &b) {
+    for (std::size_t l = 0; l < W; ++l) {
+        const double q0 = b.x.q[0][l], q1 = b.x.q[1][l], q2 = b.x.q[2][l], q3 = b.x.q[3][l];
+        const double r0 = b.qRef[0][l], r1 = -b.qRef[1][l], r2 = -b.qRef[2][l], r3 = -b.qRef[3][l];
+
+        // qErr = conj(qRef) * q
+        const double ew = r0*q0 - r1*q1 - r2*q2 - r3*q3;
+        const double ex = r0*q1 + r1*q0 + r2*q3 - r3*q2;
+        const double ey = r0*q2 - r1*q3 + r2*q0 + r3*q1;
+        const double ez = r0*q3 + r1*q2 - r2*q1 + r3*q0;
+
+        const double s = (ew >= 0.0) ? 2.0 : -2.0;
+        const double e[6] = {
+            s * ex, s * ey, s * ez,
+            b.x.w[0][l] - b.wRef[0][l],
+            b.x.w[1][l] - b.wRef[1][l],
+            b.x.w[2][l] - b.wRef[2][l]
+        };
+
+        for (std::size_t i = 0; i < 3; ++i) {
+            double ti = 0.0;
+            for (std::size_t j = 0; j < 6; ++j) {
+                ti += b.K[6 * i + j][l] * e[j];
+            }
+            b.tau[i][l] = -ti;
+        }
+    }
+}
+
+// y = x + h * k
+inline void axpy(const LaneState &x, double h, const LaneState &k, LaneState &y) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t l = 0; l < W; ++l) {
+            y.q[i][l] = x.q[i][l] + h * k.q[i][l];
+        }
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t l = 0; l < W; ++l) {
+            y.w[i][l] = x.w[i][l] + h * k.w[i][l];
+        }
+    }
+}
+
+inline void stepRK4(LaneBlock &b, double dt) {
+    LaneState k1, k2, k3, k4, tmp;
+
+    derivative(b, b.x, k1);
+    axpy(b.x, 0.5 * dt, k1, tmp);
+    derivative(b, tmp, k2);
+    axpy(b.x, 0.5 * dt, k2, tmp);
+    derivative(b, tmp, k3);
+    axpy(b.x, dt, k3, tmp);
+    derivative(b, tmp, k4);
+
+    const double h6 = dt / 6.0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t l = 0; l < W; ++l) {
+            b.x.q[i][l] += h6 * (k1.q[i][l] + 2.0 * k2.q[i][l] + 2.0 * k3.q[i][l] + k4.q[i][l]);
+        }
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t l = 0; l < W; ++l) {
+            b.x.w[i][l] += h6 * (k1.w[i][l] + 2.0 * k2.w[i][l] + 2.0 * k3.w[i][l] + k4.w[i][l]);
+        }
+    }
+
+    // Normalize quaternion to maintain unit norm
+    for (std::size_t l = 0; l < W; ++l) {
+        const double n2 = b.x.q[0][l] * b.x.q[0][l] + b.x.q[1][l] * b.x.q[1][l] +
+                          b.x.q[2][l] * b.x.q[2][l] + b.x.q[3][l] * b.x.q[3][l];
+        const double invNorm = 1.0 / std::sqrt(n2);
+        for (std::size_t i = 0; i < 4; ++i) {
+            b.x.q[i][l] *= invNorm;
+        }
+    }
+}
+
+// Pack cases [first, first + W) into a block; missing lanes repeat the last case
+void loadBlock(const std::vector<EnsembleCase> &cases, std::size_t first, LaneBlock &b) {
+    for (std::size_t l = 0; l < W; ++l) {
+        const EnsembleCase &c = cases[std::min(first + l, cases.size() - 1)];
+        const Mat3 Jinv = inverse(c.inertia);
+        for (std::size_t i = 0; i < 4; ++i) {
+            b.x.q[i][l] = c.q0[i];
+            b.qRef[i][l] = c.qRef[i];
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            b.x.w[i][l] = c.w0[i];
+            b.wRef[i][l] = c.wRef[i];
+            b.tau[i][l] = 0.0;
+            for (std::size_t j = 0; j < 3; ++j) {
+                b.J[3 * i + j][l] = c.inertia[i][j];
+                b.Jinv[3 * i + j][l] = Jinv[i][j];
+            }
+            for (std::size_t j = 0; j < 6; ++j) {
+                b.K[6 * i + j][l] = c.gain[i][j];
+            }
+        }
+    }
+}
+
+} // namespace
+
+Mat3x6 pdGainMatrix(const Vec3 &kpAtt, const Vec3 &kdRate) {
+    Mat3x6 K{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        K[i][i] = kpAtt[i];
+        K[i][i + 3] = kdRate[i];
+    }
+    return K;
+}
+
+EnsembleResult propagateEnsemble(
+    const std::vector<EnsembleCase> &cases,
+    const EnsembleConfig &cfg,
+    int numThreads
+) {
+    if (cfg.dt <= 0.0 || cfg.numSteps < 0) {
+        throw std::invalid_argument("propagateEnsemble: dt must be > 0 and numSteps >= 0");
+    }
+
+    const int controlPeriod = MultiRateScheduler::periodFromRate(cfg.controlRateHz, cfg.dt, "controlRateHz");
+
+    EnsembleResult result;
+    result.quats.data.resize(cases.size() * 4);
+    result.omegas.data.resize(cases.size() * 3);
+    if (cases.empty()) {
+        return result;
+    }
+
+    const std::size_t numBlocks = (cases.size() + W - 1) / W;
+    parallelFor(numBlocks, numThreads, [&](std::size_t blockIndex) {
+        const std::size_t first = blockIndex * W;
+        LaneBlock block;
+        loadBlock(cases, first, block);
+
+        // Control ticks shared by every lane (same schedule as the scalar
+        // simulation's controller task)
+        for (int k = 0; k < cfg.numSteps; ++k) {
+            if (k % controlPeriod == 0) {
+                controlLaw(block);
+            }
+            stepRK4(block, cfg.dt);
+        }
+
+        const std::size_t lanes = std::min(W, cases.size() - first);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                result.quats.data[(first + l) * 4 + i] = block.x.q[i][l];
+            }
+            for (std::size_t i = 0; i < 3; ++i) {
+                result.omegas.data[(first + l) * 3 + i] = block.x.w[i][l];
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace starSense
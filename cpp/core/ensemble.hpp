@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include "types.hpp"
+#include "simulation.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Lock-step ensemble propagator
+//
+// Propagates many independent spacecraft that share dt, step count and
+// control rate but have their own initial state, inertia, reference and
+// feedback gain. Cases are packed into fixed-width blocks of lanes stored as
+// structure-of-arrays, and every kernel (quaternion kinematics, J·w, w × Jw,
+// Jinv·rhs, the feedback law, RK4 stages) is a plain loop over the lanes of a
+// block, which the compiler turns into SIMD code. A block stays in L1 for
+// the whole run.
+//
+// Each case matches a scalar run with RigidBodyDynamics, RK4, an ideal
+// sensor and actuator and a fixed reference, up to floating-point
+// reassociation.
+// ----------------------------------------------------------
+
+// Lanes per block: one AVX-512 register, or two AVX2 registers, of doubles
+constexpr std::size_t kEnsembleLanes = 8;
+
+struct EnsembleCase {
+    Quat q0;
+    Vec3 w0;
+    Mat3 inertia;
+    Quat qRef{1.0, 0.0, 0.0, 0.0};
+    Vec3 wRef{0.0, 0.0, 0.0};
+    Mat3x6 gain{};   // tau = -gain * [e_att; e_w]; all zeros for no control
+};
+
+struct EnsembleConfig {
+    double dt;
+    int numSteps;
+    double controlRateHz = 0.0;   // 1/rate a whole number of dt steps (<= 0: every step)
+};
+
+// Final state of every case, in input order
+struct EnsembleResult {
+    QuatSeries quats;
+    Vec3Series omegas;
+};
+
+// Feedback gain equivalent to PDController(kp, kd): [diag(kp), diag(kd)]
+Mat3x6 pdGainMatrix(const Vec3 &kpAtt, const Vec3 &kdRate);
+
+// Propagate every case for cfg.numSteps RK4 steps.
+//  numThreads : workers over blocks (<= 0 uses one per hardware thread)
+EnsembleResult propagateEnsemble(
+    const std::vector<EnsembleCase> &cases,
+    const EnsembleConfig &cfg,
+    int numThreads = 0
+);
+
+} // namespace starSense
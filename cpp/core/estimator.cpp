@@ -0,0 +1,217 @@
+#include "estimator.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace starSense {
+
+namespace {
+
+// Small fixed-size helpers for the covariance blocks
+Mat3 identity3(double s) {
+    Mat3 I{};
+    I[0][0] = s;
+    I[1][1] = s;
+    I[2][2] = s;
+    return I;
+}
+
+Mat3 add(const Mat3 &A, const Mat3 &B) {
+    Mat3 C;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            C[i][j] = A[i][j] + B[i][j];
+        }
+    }
+    return C;
+}
+
+Mat3 sub(const Mat3 &A, const Mat3 &B) {
+    Mat3 C;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            C[i][j] = A[i][j] - B[i][j];
+        }
+    }
+    return C;
+}
+
+Mat3 scale(const Mat3 &A, double s) {
+    Mat3 C;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            C[i][j] = s * A[i][j];
+        }
+    }
+    return C;
+}
+
+// (A + A^T) / 2, removes round-off asymmetry from covariance blocks
+Mat3 symmetrize(const Mat3 &A) {
+    Mat3 C;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            C[i][j] = 0.5 * (A[i][j] + A[j][i]);
+        }
+    }
+    return C;
+}
+
+// Inverse of the innovation covariance S = Ptt + R. S is symmetric positive
+// definite whenever R > 0, but its determinant scales with σ⁶ and is far
+// below the absolute singularity threshold of inverse(Mat3), so invert by
+// cofactors directly.
+Mat3 inverseSpd(const Mat3 &S) {
+    const double c00 = S[1][1] * S[2][2] - S[1][2] * S[2][1];
+    const double c01 = S[1][2] * S[2][0] - S[1][0] * S[2][2];
+    const double c02 = S[1][0] * S[2][1] - S[1][1] * S[2][0];
+    const double det = S[0][0] * c00 + S[0][1] * c01 + S[0][2] * c02;
+    const double invDet = 1.0 / det;
+
+    Mat3 Sinv;
+    Sinv[0][0] = c00 * invDet;
+    Sinv[1][0] = c01 * invDet;
+    Sinv[2][0] = c02 * invDet;
+    Sinv[0][1] = (S[0][2] * S[2][1] - S[0][1] * S[2][2]) * invDet;
+    Sinv[1][1] = (S[0][0] * S[2][2] - S[0][2] * S[2][0]) * invDet;
+    Sinv[2][1] = (S[0][1] * S[2][0] - S[0][0] * S[2][1]) * invDet;
+    Sinv[0][2] = (S[0][1] * S[1][2] - S[0][2] * S[1][1]) * invDet;
+    Sinv[1][2] = (S[0][2] * S[1][0] - S[0][0] * S[1][2]) * invDet;
+    Sinv[2][2] = (S[0][0] * S[1][1] - S[0][1] * S[1][0]) * invDet;
+    return Sinv;
+}
+
+// Rotation matrix exp(-[phi×]) (Rodrigues): transition of the attitude
+// error over a step that rotates the body by phi
+Mat3 errorTransition(const Vec3 &phi) {
+    const double angle2 = dot(phi, phi);
+    const double angle = std::sqrt(angle2);
+
+    double a, b;  // sin(angle)/angle, (1 - cos(angle))/angle²
+    if (angle < 1e-4) {
+        a = 1.0 - angle2 / 6.0;
+        b = 0.5 - angle2 / 24.0;
+    } else {
+        a = std::sin(angle) / angle;
+        b = (1.0 - std::cos(angle)) / angle2;
+    }
+
+    // K = [phi×]; exp(-K) = I - a K + b K²
+    const Mat3 K{{
+        {{0.0, -phi[2], phi[1]}},
+        {{phi[2], 0.0, -phi[0]}},
+        {{-phi[1], phi[0], 0.0}}
+    }};
+    return add(sub(identity3(1.0), scale(K, a)), scale(matmul(K, K), b));
+}
+
+} // namespace
+
+AttitudeState PassThroughEstimator::estimate(
+    double t,
+    const AttitudeState &measured,
+    EstimatorState &state
+) const {
+    (void)t;
+    (void)state;
+    return measured;
+}
+
+
+// MekfEstimator
+MekfEstimator::MekfEstimator(const MekfParams &params)
+    : params_(params)
+{
+    if (!(params_.starTrackerNoise > 0.0) || params_.gyroNoise < 0.0 ||
+        params_.gyroBiasRandomWalk < 0.0 || params_.initialAttitudeSigma < 0.0 ||
+        params_.initialBiasSigma < 0.0) {
+        throw std::invalid_argument(
+            "MekfEstimator: starTrackerNoise must be > 0 and the other noise levels >= 0");
+    }
+}
+
+AttitudeState MekfEstimator::estimate(
+    double t,
+    const AttitudeState &measured,
+    EstimatorState &s
+) const {
+    // First measurement: initialize from the star tracker
+    if (!s.initialized) {
+        s.initialized = true;
+        s.lastTime = t;
+        s.q = measured.q;
+        s.gyroBias = Vec3{0.0, 0.0, 0.0};
+        s.lastGyro = measured.w;
+        s.Ptt = identity3(params_.initialAttitudeSigma * params_.initialAttitudeSigma);
+        s.Ptb = Mat3{};
+        s.Pbb = identity3(params_.initialBiasSigma * params_.initialBiasSigma);
+        return AttitudeState{s.q, sub(measured.w, s.gyroBias), measured.h};
+    }
+
+    // 1. Propagate from lastTime to t with the held gyro measurement
+    const double dt = t - s.lastTime;
+    if (dt > 0.0) {
+        const Vec3 w = sub(s.lastGyro, s.gyroBias);
+        const Vec3 phi{w[0] * dt, w[1] * dt, w[2] * dt};
+        s.q = normalize(quatMultiply(s.q, quatFromRotationVector(phi)));
+
+        // Phi = [[F, -dt I], [0, I]]  =>
+        //   Ptt' = (F Ptt - dt Ptb^T) F^T - dt (F Ptb - dt Pbb)
+        //   Ptb' = F Ptb - dt Pbb
+        //   Pbb' = Pbb
+        const Mat3 F = errorTransition(phi);
+        const Mat3 FPtb = matmul(F, s.Ptb);
+        const Mat3 Ptb1 = sub(FPtb, scale(s.Pbb, dt));
+        const Mat3 Ptt1 = sub(
+            matmul(sub(matmul(F, s.Ptt), scale(transpose(s.Ptb), dt)), transpose(F)),
+            scale(Ptb1, dt));
+
+        // Discrete process noise (gyro white noise + bias random walk)
+        const double sv2 = params_.gyroNoise * params_.gyroNoise;
+        const double su2 = params_.gyroBiasRandomWalk * params_.gyroBiasRandomWalk;
+        const double qtt = sv2 * dt * dt + su2 * dt * dt * dt / 3.0;
+        const double qtb = -0.5 * su2 * dt * dt;
+        const double qbb = su2 * dt;
+
+        s.Ptt = symmetrize(add(Ptt1, identity3(qtt)));
+        s.Ptb = add(Ptb1, identity3(qtb));
+        s.Pbb = add(s.Pbb, identity3(qbb));
+    }
+    s.lastTime = t;
+
+    // 2. Star tracker update: z = 2 vec(q̂^{-1} ⊗ q_meas), H = [I 0]
+    Quat dq = quatMultiply(quatConjugate(s.q), measured.q);
+    if (dq[0] < 0.0) {
+        dq = Quat{-dq[0], -dq[1], -dq[2], -dq[3]};
+    }
+    const Vec3 z{2.0 * dq[1], 2.0 * dq[2], 2.0 * dq[3]};
+
+    // S = Ptt + R, K = [Ptt; Ptb^T] S^{-1}
+    const double r2 = params_.starTrackerNoise * params_.starTrackerNoise;
+    const Mat3 Sinv = inverseSpd(add(s.Ptt, identity3(r2)));
+    const Mat3 PbtT = transpose(s.Ptb);
+    const Mat3 Kt = matmul(s.Ptt, Sinv);
+    const Mat3 Kb = matmul(PbtT, Sinv);
+
+    const Vec3 dTheta = matmul(Kt, z);
+    const Vec3 dBias = matmul(Kb, z);
+
+    // P - K S K^T = P - [Ptt; Ptb^T] S^{-1} [Ptt, Ptb]
+    const Mat3 PttNew = sub(s.Ptt, matmul(Kt, s.Ptt));
+    const Mat3 PtbNew = sub(s.Ptb, matmul(Kt, s.Ptb));
+    const Mat3 PbbNew = sub(s.Pbb, matmul(Kb, s.Ptb));
+    s.Ptt = symmetrize(PttNew);
+    s.Ptb = PtbNew;
+    s.Pbb = symmetrize(PbbNew);
+
+    // 3. Reset: fold the error state into the estimate
+    const Quat dqCorr{1.0, 0.5 * dTheta[0], 0.5 * dTheta[1], 0.5 * dTheta[2]};
+    s.q = normalize(quatMultiply(s.q, dqCorr));
+    s.gyroBias = add(s.gyroBias, dBias);
+
+    // Rate estimate from the current gyro sample, held for the next propagation
+    s.lastGyro = measured.w;
+    return AttitudeState{s.q, sub(measured.w, s.gyroBias), measured.h};
+}
+
+} // namespace starSense
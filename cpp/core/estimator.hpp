@@ -0,0 +1,79 @@
+#pragma once
+
+#include "types.hpp"
+#include "util.hpp"
+
+namespace starSense {
+
+// Per-run estimator state. The 6x6 error covariance of the MEKF
+// ([δθ; δb], attitude error and gyro bias error) is kept as its three
+// distinct 3x3 blocks, P = [[Ptt, Ptb], [Ptb^T, Pbb]], so every operation
+// is on fixed-size arrays and a step never allocates.
+struct EstimatorState {
+    bool initialized = false;
+    double lastTime = 0.0;           // time of the previous update
+    Quat q{1.0, 0.0, 0.0, 0.0};      // attitude estimate
+    Vec3 gyroBias{0.0, 0.0, 0.0};    // gyro bias estimate [rad/s]
+    Vec3 lastGyro{0.0, 0.0, 0.0};    // previous gyro measurement, held until the next one
+    Mat3 Ptt{};                      // attitude error covariance [rad²]
+    Mat3 Ptb{};                      // attitude / bias cross covariance
+    Mat3 Pbb{};                      // bias error covariance [(rad/s)²]
+};
+
+// Abstract estimator interface: turns sensor measurements into the state
+// estimate the controller acts on
+class Estimator {
+public:
+    virtual ~Estimator() = default;
+
+    // State at the start of a run
+    virtual EstimatorState initialState() const { return EstimatorState{}; }
+
+    // Estimate the attitude state.
+    //  t        : current simulation time [s]
+    //  measured : sensor output (star tracker q, gyro w)
+    //  state    : per-run estimator state, updated in place
+    virtual AttitudeState estimate(
+        double t,
+        const AttitudeState &measured,
+        EstimatorState &state
+    ) const = 0;
+};
+
+// No estimation: the controller acts on the raw measurements
+class PassThroughEstimator final : public Estimator {
+public:
+    AttitudeState estimate(
+        double t,
+        const AttitudeState &measured,
+        EstimatorState &state
+    ) const override;
+};
+
+// Multiplicative extended Kalman filter (Lefferts, Markley & Shuster 1982)
+// fusing gyro rates with star tracker quaternions. The gyro drives the
+// propagation, the star tracker quaternion is the measurement, and the
+// 6-state error [δθ; δb] is folded back into (q, b) after every update.
+struct MekfParams {
+    double starTrackerNoise = 1e-4;      // measurement 1σ per axis [rad]
+    double gyroNoise = 1e-5;             // gyro white noise 1σ per sample [rad/s]
+    double gyroBiasRandomWalk = 1e-7;    // bias drift density [rad/s/√s]
+    double initialAttitudeSigma = 1e-2;  // initial attitude uncertainty [rad]
+    double initialBiasSigma = 1e-3;      // initial bias uncertainty [rad/s]
+};
+
+class MekfEstimator final : public Estimator {
+public:
+    explicit MekfEstimator(const MekfParams &params);
+
+    AttitudeState estimate(
+        double t,
+        const AttitudeState &measured,
+        EstimatorState &state
+    ) const override;
+
+private:
+    MekfParams params_;
+};
+
+} // namespace starSense
@@ -0,0 +1,60 @@
+#include "events.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "util.hpp"
+
+namespace starSense {
+
+Event attitudeErrorBelowEvent(double threshold, bool terminal) {
+    if (!(threshold > 0.0)) {
+        throw std::invalid_argument("attitudeErrorBelowEvent: threshold must be > 0");
+    }
+    Event event;
+    event.name = "attitudeError";
+    event.direction = EventDirection::Falling;
+    event.terminal = terminal;
+    event.g = [threshold](const EventSample &s) {
+        // |e_att| with e_att = 2 sign(qErr_w) qErr_v, qErr = q_ref^{-1} ⊗ q
+        const Quat qErr = quatMultiply(quatConjugate(s.ref.qRef), s.x.q);
+        const double vNorm = std::sqrt(qErr[1] * qErr[1] + qErr[2] * qErr[2] + qErr[3] * qErr[3]);
+        return 2.0 * vNorm - threshold;
+    };
+    return event;
+}
+
+Event rateErrorBelowEvent(double threshold, bool terminal) {
+    if (!(threshold > 0.0)) {
+        throw std::invalid_argument("rateErrorBelowEvent: threshold must be > 0");
+    }
+    Event event;
+    event.name = "rateError";
+    event.direction = EventDirection::Falling;
+    event.terminal = terminal;
+    event.g = [threshold](const EventSample &s) {
+        const Vec3 eW = sub(s.x.w, s.ref.wRef);
+        return std::sqrt(dot(eW, eW)) - threshold;
+    };
+    return event;
+}
+
+Event wheelSpeedLimitEvent(const std::vector<double> &maxSpeedRPM, bool terminal) {
+    Event event;
+    event.name = "wheelSpeedLimit";
+    event.direction = EventDirection::Rising;
+    event.terminal = terminal;
+    event.g = [maxSpeedRPM](const EventSample &s) {
+        // Largest margin past the limit over all wheels (< 0: all within)
+        double g = -std::numeric_limits<double>::infinity();
+        const std::size_t n = std::min(s.numWheels, maxSpeedRPM.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            g = std::max(g, std::abs(s.wheelSpeeds[i]) - maxSpeedRPM[i]);
+        }
+        return g;
+    };
+    return event;
+}
+
+} // namespace starSense
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+#include "referenceProfile.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Simulation events
+//
+// An event is a scalar function g of the simulation state whose zero
+// crossings mark something of interest: the attitude error falling below a
+// tolerance, a wheel reaching its speed limit. After every integrator step
+// the simulation checks each g for a sign change over the step and locates
+// the crossing by root finding on the step's interpolant, so event times
+// are not quantized to dt. An event records its time, ends the run, or both.
+// ----------------------------------------------------------
+
+// What an event function sees at time t
+struct EventSample {
+    double t;
+    const AttitudeState &x;      // true state
+    const ReferenceState &ref;   // reference at t
+    const double *wheelSpeeds;   // [RPM], numWheels values
+    std::size_t numWheels;
+};
+
+enum class EventDirection {
+    Any,      // either sign change
+    Rising,   // g from negative to positive
+    Falling   // g from positive to negative
+};
+
+struct Event {
+    std::string name;
+    std::function<double(const EventSample &)> g;
+    EventDirection direction = EventDirection::Any;
+    bool record = true;      // add every crossing to SimulationResult::events
+    bool terminal = false;   // end the run at the first crossing
+};
+
+// One located crossing
+struct EventOccurrence {
+    std::string name;
+    double t;
+};
+
+// |attitude error| falls below threshold [rad] (error as logged in attitudeError)
+Event attitudeErrorBelowEvent(double threshold, bool terminal = false);
+
+// |ω − ω_ref| falls below threshold [rad/s]
+Event rateErrorBelowEvent(double threshold, bool terminal = false);
+
+// Any reaction wheel reaches its speed limit [RPM]
+Event wheelSpeedLimitEvent(const std::vector<double> &maxSpeedRPM, bool terminal = false);
+
+// Does g cross zero in `direction` going from ga (start of a step) to gb (end)?
+inline bool eventCrossed(EventDirection direction, double ga, double gb) {
+    const bool rising = (ga < 0.0 && gb >= 0.0);
+    const bool falling = (ga > 0.0 && gb <= 0.0);
+    switch (direction) {
+    case EventDirection::Rising:
+        return rising;
+    case EventDirection::Falling:
+        return falling;
+    case EventDirection::Any:
+    default:
+        return rising || falling;
+    }
+}
+
+// Crossing time of g in [ta, tb] given ga = g(ta), gb = g(tb) on opposite
+// sides of zero. Illinois variant of regula falsi: superlinear, and the
+// bracket never grows, so g only needs to be continuous.
+template <typename G>
+double locateEventTime(G &&g, double ta, double ga, double tb, double gb) {
+    const double tol = 4.0 * 2.220446049250313e-16 * std::max(std::abs(tb), 1.0);
+    int side = 0;
+    for (int it = 0; it < 60 && tb - ta > tol; ++it) {
+        const double t = (gb == ga) ? 0.5 * (ta + tb) : tb - gb * (tb - ta) / (gb - ga);
+        const double gt = g(t);
+        if ((gt > 0.0) == (gb > 0.0) && gt != 0.0) {
+            // Root in [ta, t]: replace the b end, halve the stale a value
+            // if a was kept twice in a row
+            tb = t;
+            gb = gt;
+            if (side == -1) {
+                ga *= 0.5;
+            }
+            side = -1;
+        } else if (gt == 0.0) {
+            return t;
+        } else {
+            ta = t;
+            ga = gt;
+            if (side == 1) {
+                gb *= 0.5;
+            }
+            side = 1;
+        }
+    }
+    return tb;
+}
+
+} // namespace starSense
@@ -2,137 +2,77 @@
 
 namespace starSense {
 
-Integrator::Integrator(IntegrationMethod method)
-    : method_(method) {}
-
-// Euler step 
-AttitudeState Integrator::stepEuler_(
-    const AttitudeDynamics &dyn,
-    double t,
-    const AttitudeState &x,
-    double dt,
-    const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-) const {
-    // Single torque sample per step (also logs via torqueFunc)
-    Vec3 tau = torqueFunc(t, x);
-
-    // State derivative
-    AttitudeState xdot = dyn.computeDerivative(t, x, tau);
-
-    // Forward Euler update
-    AttitudeState xNext;
-
-    // Quaternion components
-    for (std::size_t i = 0; i < 4; ++i) {
-        xNext.q[i] = x.q[i] + dt * xdot.q[i];
+IntegratorBase::IntegratorBase(IntegratorTolerances tolerances)
+    : tolerances_(tolerances) {
+    if (tolerances_.absTol <= 0.0 || tolerances_.relTol < 0.0) {
+        throw std::invalid_argument(
+            "Integrator: absTol must be > 0 and relTol must be >= 0");
     }
-
-    // Angular rate components
-    for (std::size_t i = 0; i < 3; ++i) {
-        xNext.w[i] = x.w[i] + dt * xdot.w[i];
-    }
-
-    // Enforce unit quaternion
-    xNext.q = normalize(xNext.q);
-
-    return xNext;
 }
 
-// RK4 step 
-AttitudeState Integrator::stepRK4_(
-    const AttitudeDynamics &dyn,
-    double t,
-    const AttitudeState &x,
-    double dt,
-    const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-) const {
-    // Sample torque *once* at the start of the step.
-    // We hold it constant over the step (good enough for now).
-    Vec3 tau = torqueFunc(t, x);
-
-    // k1
-    AttitudeState k1 = dyn.computeDerivative(t, x, tau);
-
-    // x + dt/2 * k1
-    AttitudeState xTemp;
-    for (std::size_t i = 0; i < 4; ++i) {
-        xTemp.q[i] = x.q[i] + 0.5 * dt * k1.q[i];
-    }
-    for (std::size_t i = 0; i < 3; ++i) {
-        xTemp.w[i] = x.w[i] + 0.5 * dt * k1.w[i];
+// Dormand–Prince dense output (Hairer's 4th-order interpolant, as in
+// DOPRI5): x(t0 + s*h) = x0 + h * sum_j k_j * (P_j1 s + P_j2 s^2 + P_j3 s^3 + P_j4 s^4)
+AttitudeState DenseOutput::operator()(double t) const {
+    static constexpr double P[7][4] = {
+        {1.0, -8048581381.0 / 2820520608.0, 8663915743.0 / 2820520608.0,
+         -12715105075.0 / 11282082432.0},
+        {0.0, 0.0, 0.0, 0.0},
+        {0.0, 131558114200.0 / 32700410799.0, -68118460800.0 / 10900136933.0,
+         87487479700.0 / 32700410799.0},
+        {0.0, -1754552775.0 / 470086768.0, 14199869525.0 / 1410260304.0,
+         -10690763975.0 / 1880347072.0},
+        {0.0, 127303824393.0 / 49829197408.0, -318862633887.0 / 49829197408.0,
+         701980252875.0 / 199316789632.0},
+        {0.0, -282668133.0 / 205662961.0, 2019193451.0 / 616988883.0,
+         -1453857185.0 / 822651844.0},
+        {0.0, 40617522.0 / 29380423.0, -110615467.0 / 29380423.0,
+         69997945.0 / 29380423.0}
+    };
+
+    const double s = (h > 0.0) ? (t - t0) / h : 0.0;
+    const double sPow[4] = {s, s * s, s * s * s, s * s * s * s};
+
+    // Per-stage weight at this s
+    double w[7];
+    for (std::size_t j = 0; j < 7; ++j) {
+        w[j] = P[j][0] * sPow[0] + P[j][1] * sPow[1] + P[j][2] * sPow[2] + P[j][3] * sPow[3];
     }
-    AttitudeState k2 = dyn.computeDerivative(t + 0.5 * dt, xTemp, tau);
 
-    // x + dt/2 * k2
-    for (std::size_t i = 0; i < 4; ++i) {
-        xTemp.q[i] = x.q[i] + 0.5 * dt * k2.q[i];
-    }
-    for (std::size_t i = 0; i < 3; ++i) {
-        xTemp.w[i] = x.w[i] + 0.5 * dt * k2.w[i];
+    AttitudeState x = x0;
+    for (std::size_t j = 0; j < 7; ++j) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            x.q[i] += h * w[j] * k[j].q[i];
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            x.w[i] += h * w[j] * k[j].w[i];
+            x.h[i] += h * w[j] * k[j].h[i];
+        }
     }
-    AttitudeState k3 = dyn.computeDerivative(t + 0.5 * dt, xTemp, tau);
+    x.q = normalize(x.q);
+    return x;
+}
 
-    // x + dt * k3
-    for (std::size_t i = 0; i < 4; ++i) {
-        xTemp.q[i] = x.q[i] + dt * k3.q[i];
-    }
-    for (std::size_t i = 0; i < 3; ++i) {
-        xTemp.w[i] = x.w[i] + dt * k3.w[i];
-    }
-    AttitudeState k4 = dyn.computeDerivative(t + dt, xTemp, tau);
+AttitudeState HermiteOutput::operator()(double t) const {
+    const double s = (h > 0.0) ? (t - t0) / h : 0.0;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+
+    // Hermite basis
+    const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    const double h10 = (s3 - 2.0 * s2 + s) * h;
+    const double h01 = -2.0 * s3 + 3.0 * s2;
+    const double h11 = (s3 - s2) * h;
 
-    // Combine stages
-    AttitudeState xNext;
+    AttitudeState x;
     for (std::size_t i = 0; i < 4; ++i) {
-        xNext.q[i] = x.q[i] + (dt / 6.0) *
-            (k1.q[i] + 2.0 * k2.q[i] + 2.0 * k3.q[i] + k4.q[i]);
+        x.q[i] = h00 * x0.q[i] + h10 * f0.q[i] + h01 * x1.q[i] + h11 * f1.q[i];
     }
     for (std::size_t i = 0; i < 3; ++i) {
-        xNext.w[i] = x.w[i] + (dt / 6.0) *
-            (k1.w[i] + 2.0 * k2.w[i] + 2.0 * k3.w[i] + k4.w[i]);
+        x.w[i] = h00 * x0.w[i] + h10 * f0.w[i] + h01 * x1.w[i] + h11 * f1.w[i];
+        x.h[i] = h00 * x0.h[i] + h10 * f0.h[i] + h01 * x1.h[i] + h11 * f1.h[i];
     }
-
-    // Normalize quaternion to maintain unit norm
-    xNext.q = normalize(xNext.q);
-
-    return xNext;
-}
-
-// Propagation loop 
-std::vector<AttitudeState> Integrator::integrate(
-    const AttitudeDynamics &dynamics,
-    double t0,
-    const AttitudeState &x0,
-    double dt,
-    int numSteps,
-    const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-) const {
-    std::vector<AttitudeState> states;
-    states.reserve(static_cast<std::size_t>(numSteps) + 1);
-
-    double t = t0;
-    AttitudeState x = x0;
-
-    states.push_back(x);
-
-    for (int k = 0; k < numSteps; ++k) {
-        switch (method_) {
-        case IntegrationMethod::Euler:
-            x = stepEuler_(dynamics, t, x, dt, torqueFunc);
-            break;
-        case IntegrationMethod::RK4:
-            x = stepRK4_(dynamics, t, x, dt, torqueFunc);
-            break;
-        default:
-            x = stepRK4_(dynamics, t, x, dt, torqueFunc);
-            break;
-        }
-
-        t += dt;
-        states.push_back(x);
-    }
-
-    return states;
+    x.q = normalize(x.q);
+    return x;
 }
 
-} // namespace starSense
\ No newline at end of file
+} // namespace starSense
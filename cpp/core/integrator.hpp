@@ -1,6 +1,6 @@
 #pragma once
-#include <vector>
-#include <functional>
+#include <limits>
+#include <stdexcept>
 
 #include "types.hpp"
 #include "dynamics.hpp"
@@ -10,41 +10,493 @@ namespace starSense {
 
 enum class IntegrationMethod {
     Euler,
-    RK4
+    RK4,
+    RK45,   // adaptive Dormand–Prince 5(4) with dense output
+    RKMK4   // Lie-group RK4 (Runge–Kutta–Munthe-Kaas): attitude stays on S³
 };
 
-class Integrator {
+// Error control for adaptive methods (ignored by fixed-step methods).
+// A step is accepted when the RMS over state components of
+// err_i / (absTol + relTol * max(|x_i|, |xNew_i|)) is <= 1.
+struct IntegratorTolerances {
+    double absTol = 1e-9;
+    double relTol = 1e-6;
+};
+
+// Step counters reported by the adaptive propagation
+struct IntegratorStats {
+    int acceptedSteps = 0;
+    int rejectedSteps = 0;
+};
+
+// 4th-order continuous extension of one accepted Dormand–Prince step.
+// Evaluates the state anywhere inside [t0, t0 + h].
+struct DenseOutput {
+    double t0;
+    double h;
+    AttitudeState x0;
+    std::array<AttitudeState, 7> k;  // stage derivatives of the step
+
+    AttitudeState operator()(double t) const;
+};
+
+// Cubic Hermite interpolant of one fixed step from its end states and their
+// derivatives. Third-order accurate inside [t0, t0 + h]; used where a
+// fixed-step method has no continuous extension of its own (event location).
+struct HermiteOutput {
+    double t0;
+    double h;
+    AttitudeState x0, x1;  // states at t0 and t0 + h
+    AttitudeState f0, f1;  // derivatives at t0 and t0 + h
+
+    AttitudeState operator()(double t) const;
+};
+
+// Stepping kernels and adaptive propagation shared by Integrator and
+// StaticIntegrator.
+//
+// The kernels are templates on the dynamics type so that, when the caller
+// passes a concrete (final) dynamics class, computeDerivative is resolved
+// statically and can be inlined into the step.
+class IntegratorBase {
 public:
-    explicit Integrator(IntegrationMethod method);
+    const IntegratorTolerances &tolerances() const { return tolerances_; }
+
+    // Adaptive propagation from t to exactly tEnd with body torque tau held
+    // over the whole interval (one actuator sample-and-hold period). Steps
+    // never cross tEnd, so the step size is bounded by the actuator period:
+    // a controller running every dt (controlRateHz <= 0) limits rk45 to one
+    // step per dt, and long steps need a slower control rate.
+    //
+    //  h      : step-size guess on entry, suggested next step on exit, so
+    //           consecutive hold intervals reuse the controller's step size
+    //  stats  : accepted / rejected step counters, incremented in place
+    //  onStep : called as onStep(ta, xa, tb, xb, dense) after every accepted
+    //           step; dense(t) evaluates the interpolant for t in [ta, tb].
+    //           Returning false stops the propagation after that step.
+    //
+    // Returns the state at tEnd, or at the end of the step onStep stopped on.
+    template <typename Dyn, typename StepFn>
+    AttitudeState propagateAdaptive(
+        const Dyn &dynamics,
+        double t,
+        const AttitudeState &x,
+        double tEnd,
+        const Vec3 &tau,
+        double &h,
+        IntegratorStats &stats,
+        StepFn &&onStep
+    ) const {
+        auto deriv = [&dynamics, &tau](double s, const AttitudeState &y) {
+            return dynamics.computeDerivative(s, y, tau);
+        };
+
+        // First-same-as-last: the derivative at the end of an accepted step
+        // is the next step's first stage. A rejected step retries from the
+        // same point, so k0 stays valid; it is only recomputed here, because
+        // a new hold interval brings a new torque.
+        AttitudeState xCur = x;
+        AttitudeState k0 = deriv(t, xCur);
+        while (t < tEnd) {
+            const double remaining = tEnd - t;
+            const double minStep = 16.0 * std::numeric_limits<double>::epsilon()
+                * std::max(std::abs(t), 1.0);
+
+            // Land exactly on tEnd; stretch slightly rather than leave a sliver
+            bool last = false;
+            double hStep = h;
+            if (hStep >= remaining || remaining - hStep < minStep) {
+                hStep = remaining;
+                last = true;
+            }
+
+            DenseOutput dense;
+            AttitudeState xNew;
+            const double err = stepDormandPrince_(deriv, t, xCur, k0, hStep, dense, xNew);
+
+            // Standard step-size controller (order 5 → exponent 1/5)
+            const double factor = (err == 0.0)
+                ? 10.0
+                : std::min(10.0, std::max(0.2, 0.9 * std::pow(err, -0.2)));
+
+            if (err <= 1.0) {
+                const double tNew = last ? tEnd : t + hStep;
+                const bool proceed = onStep(t, xCur, tNew, xNew, dense);
+                ++stats.acceptedSteps;
+
+                t = tNew;
+                xCur = xNew;
+                k0 = dense.k[6];
+                // Do not let the clipped final step shrink the carried guess
+                h = last ? std::max(h, hStep * factor) : hStep * factor;
+                if (!proceed) {
+                    break;
+                }
+            } else {
+                ++stats.rejectedSteps;
+                h = hStep * factor;
+                if (h < minStep) {
+                    throw std::runtime_error(
+                        "Integrator (rk45): step size underflow; tolerances too tight");
+                }
+            }
+        }
+        return xCur;
+    }
 
-    // Integrate from t0, x0 forward with fixed step dt
-    std::vector<AttitudeState> integrate(
-        const AttitudeDynamics &dynamics,
-        double t0,
-        const AttitudeState &x0,
+protected:
+    // Throws std::invalid_argument unless absTol > 0 and relTol >= 0
+    explicit IntegratorBase(IntegratorTolerances tolerances);
+
+    // One fixed step of method M with body torque tau held over the step.
+    // RK45 has no fixed step of its own and takes an RK4 step.
+    template <IntegrationMethod M, typename Dyn>
+    static AttitudeState stepWith_(
+        const Dyn &dynamics,
+        double t,
+        const AttitudeState &x,
         double dt,
-        int numSteps,
-        const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-    ) const;
+        const Vec3 &tau
+    ) {
+        auto deriv = [&dynamics, &tau](double s, const AttitudeState &y) {
+            return dynamics.computeDerivative(s, y, tau);
+        };
 
-private:
-    IntegrationMethod method_;
+        if constexpr (M == IntegrationMethod::Euler) {
+            return stepEuler_(deriv, t, x, dt);
+        } else if constexpr (M == IntegrationMethod::RKMK4) {
+            return stepRKMK4_(deriv, t, x, dt);
+        } else {
+            return stepRK4_(deriv, t, x, dt);
+        }
+    }
+
+    IntegratorTolerances tolerances_;
+
+    // RKMK4 step on S³ x R³.
+    //
+    // The attitude is written as q(t) = q ⊗ Exp(phi(t)) with phi(t) = 0, and
+    // classic RK4 is applied to the rotation vector phi, whose kinematics are
+    //   phi_dot = dexpinv(phi, w) = w + 1/2 phi × w + 1/12 phi × (phi × w)
+    // (right-trivialized, truncated at the order needed for 4th-order
+    // accuracy), together with the rates w in R³. Each stage and the final
+    // update map back through the exponential, so the quaternion is a
+    // product of unit quaternions and keeps unit norm by construction, and a
+    // rotation of any size per step is represented exactly. This assumes the
+    // shared body-rate kinematics q_dot = 1/2 q ⊗ [0, w]; deriv is only used
+    // for w_dot and the rotor momentum rate h_dot (h is Euclidean, like w).
+    template <typename Deriv>
+    static AttitudeState stepRKMK4_(
+        Deriv &deriv,
+        double t,
+        const AttitudeState &x,
+        double dt
+    ) {
+        auto dexpInv = [](const Vec3 &phi, const Vec3 &w) {
+            Vec3 pxw = cross(phi, w);
+            Vec3 pxpxw = cross(phi, pxw);
+            return Vec3{
+                w[0] + 0.5 * pxw[0] + pxpxw[0] / 12.0,
+                w[1] + 0.5 * pxw[1] + pxpxw[1] / 12.0,
+                w[2] + 0.5 * pxw[2] + pxpxw[2] / 12.0
+            };
+        };
 
-    AttitudeState stepEuler_(
-        const AttitudeDynamics &dyn,
+        // k1 (phi = 0: the stage attitude is x.q itself)
+        Vec3 kPhi1 = x.w;
+        const AttitudeState d1 = deriv(t, x);
+        Vec3 kW1 = d1.w;
+        Vec3 kH1 = d1.h;
+
+        // stage at phi = c * dt * kPhi, w = x.w + c * dt * kW, h = x.h + c * dt * kH
+        Vec3 phi, wTemp, hTemp;
+        auto stage = [&](double c, const Vec3 &kPhi, const Vec3 &kW, const Vec3 &kH,
+                         Vec3 &kPhiOut, Vec3 &kWOut, Vec3 &kHOut) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                phi[i]   = c * dt * kPhi[i];
+                wTemp[i] = x.w[i] + c * dt * kW[i];
+                hTemp[i] = x.h[i] + c * dt * kH[i];
+            }
+            AttitudeState xTemp{quatMultiply(x.q, quatFromRotationVector(phi)), wTemp, hTemp};
+            const AttitudeState d = deriv(t + c * dt, xTemp);
+            kWOut = d.w;
+            kHOut = d.h;
+            kPhiOut = dexpInv(phi, wTemp);
+        };
+
+        Vec3 kPhi2, kW2, kH2, kPhi3, kW3, kH3, kPhi4, kW4, kH4;
+        stage(0.5, kPhi1, kW1, kH1, kPhi2, kW2, kH2);
+        stage(0.5, kPhi2, kW2, kH2, kPhi3, kW3, kH3);
+        stage(1.0, kPhi3, kW3, kH3, kPhi4, kW4, kH4);
+
+        // Combine stages
+        AttitudeState xNext;
+        for (std::size_t i = 0; i < 3; ++i) {
+            phi[i] = (dt / 6.0) *
+                (kPhi1[i] + 2.0 * kPhi2[i] + 2.0 * kPhi3[i] + kPhi4[i]);
+            xNext.w[i] = x.w[i] + (dt / 6.0) *
+                (kW1[i] + 2.0 * kW2[i] + 2.0 * kW3[i] + kW4[i]);
+            xNext.h[i] = x.h[i] + (dt / 6.0) *
+                (kH1[i] + 2.0 * kH2[i] + 2.0 * kH3[i] + kH4[i]);
+        }
+        xNext.q = quatMultiply(x.q, quatFromRotationVector(phi));
+
+        return xNext;
+    }
+
+    // One Dormand–Prince 5(4) step of size h from x, whose derivative k0 is
+    // already known. Writes the 5th-order solution to xNew and the step's
+    // interpolant to dense (dense.k[6] is the derivative at xNew); returns
+    // the scaled error norm (accept when <= 1).
+    template <typename Deriv>
+    double stepDormandPrince_(
+        Deriv &deriv,
+        double t,
+        const AttitudeState &x,
+        const AttitudeState &k0,
+        double h,
+        DenseOutput &dense,
+        AttitudeState &xNew
+    ) const {
+        static constexpr double c2 = 1.0 / 5.0, c3 = 3.0 / 10.0, c4 = 4.0 / 5.0, c5 = 8.0 / 9.0;
+
+        static constexpr double a21 = 1.0 / 5.0;
+        static constexpr double a31 = 3.0 / 40.0,        a32 = 9.0 / 40.0;
+        static constexpr double a41 = 44.0 / 45.0,       a42 = -56.0 / 15.0,      a43 = 32.0 / 9.0;
+        static constexpr double a51 = 19372.0 / 6561.0,  a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0,
+                                a54 = -212.0 / 729.0;
+        static constexpr double a61 = 9017.0 / 3168.0,   a62 = -355.0 / 33.0,     a63 = 46732.0 / 5247.0,
+                                a64 = 49.0 / 176.0,      a65 = -5103.0 / 18656.0;
+
+        // 5th-order weights (also row 7 of A: FSAL)
+        static constexpr double b1 = 35.0 / 384.0, b3 = 500.0 / 1113.0, b4 = 125.0 / 192.0,
+                                b5 = -2187.0 / 6784.0, b6 = 11.0 / 84.0;
+
+        // Error weights: b(5th) - b(4th)
+        static constexpr double e1 = -71.0 / 57600.0, e3 = 71.0 / 16695.0, e4 = -71.0 / 1920.0,
+                                e5 = 17253.0 / 339200.0, e6 = -22.0 / 525.0, e7 = 1.0 / 40.0;
+
+        std::array<AttitudeState, 7> &k = dense.k;
+        AttitudeState y;
+
+        // y = x + h * sum_j a_j k_j, over quaternion and rate components
+        auto stage = [&](std::initializer_list<double> a) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                double acc = 0.0;
+                std::size_t j = 0;
+                for (double aj : a) { acc += aj * k[j++].q[i]; }
+                y.q[i] = x.q[i] + h * acc;
+            }
+            for (std::size_t i = 0; i < 3; ++i) {
+                double acc = 0.0;
+                std::size_t j = 0;
+                for (double aj : a) { acc += aj * k[j++].w[i]; }
+                y.w[i] = x.w[i] + h * acc;
+            }
+            for (std::size_t i = 0; i < 3; ++i) {
+                double acc = 0.0;
+                std::size_t j = 0;
+                for (double aj : a) { acc += aj * k[j++].h[i]; }
+                y.h[i] = x.h[i] + h * acc;
+            }
+            return y;
+        };
+
+        k[0] = k0;
+        k[1] = deriv(t + c2 * h, stage({a21}));
+        k[2] = deriv(t + c3 * h, stage({a31, a32}));
+        k[3] = deriv(t + c4 * h, stage({a41, a42, a43}));
+        k[4] = deriv(t + c5 * h, stage({a51, a52, a53, a54}));
+        k[5] = deriv(t + h,      stage({a61, a62, a63, a64, a65}));
+        // Normalized before the last stage so that k[6] is the derivative at
+        // the state the next step starts from
+        xNew = stage({b1, 0.0, b3, b4, b5, b6});
+        xNew.q = normalize(xNew.q);
+        k[6] = deriv(t + h, xNew);
+
+        // Scaled RMS error over the 7 attitude and rate components. The
+        // rotor momentum is left out: its rate is the held wheel torque,
+        // constant over the step, so every stage integrates it exactly.
+        const auto &tol = tolerances_;
+        double sumSq = 0.0;
+        auto accumulate = [&](double x0, double x1, double errI) {
+            const double scale = tol.absTol + tol.relTol * std::max(std::abs(x0), std::abs(x1));
+            sumSq += (errI / scale) * (errI / scale);
+        };
+        for (std::size_t i = 0; i < 4; ++i) {
+            const double errI = h * (e1 * k[0].q[i] + e3 * k[2].q[i] + e4 * k[3].q[i]
+                                   + e5 * k[4].q[i] + e6 * k[5].q[i] + e7 * k[6].q[i]);
+            accumulate(x.q[i], xNew.q[i], errI);
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            const double errI = h * (e1 * k[0].w[i] + e3 * k[2].w[i] + e4 * k[3].w[i]
+                                   + e5 * k[4].w[i] + e6 * k[5].w[i] + e7 * k[6].w[i]);
+            accumulate(x.w[i], xNew.w[i], errI);
+        }
+
+        dense.t0 = t;
+        dense.h = h;
+        dense.x0 = x;
+
+        return std::sqrt(sumSq / 7.0);
+    }
+
+    // Euler step; deriv(t, x) returns xdot
+    template <typename Deriv>
+    static AttitudeState stepEuler_(
+        Deriv &deriv,
+        double t,
+        const AttitudeState &x,
+        double dt
+    ) {
+        // State derivative
+        AttitudeState xdot = deriv(t, x);
+
+        // Forward Euler update
+        AttitudeState xNext;
+
+        // Quaternion components
+        for (std::size_t i = 0; i < 4; ++i) {
+            xNext.q[i] = x.q[i] + dt * xdot.q[i];
+        }
+
+        // Angular rate and rotor momentum components
+        for (std::size_t i = 0; i < 3; ++i) {
+            xNext.w[i] = x.w[i] + dt * xdot.w[i];
+            xNext.h[i] = x.h[i] + dt * xdot.h[i];
+        }
+
+        // Enforce unit quaternion
+        xNext.q = normalize(xNext.q);
+
+        return xNext;
+    }
+
+    // RK4 step; deriv(t, x) returns xdot
+    template <typename Deriv>
+    static AttitudeState stepRK4_(
+        Deriv &deriv,
+        double t,
+        const AttitudeState &x,
+        double dt
+    ) {
+        // k1
+        AttitudeState k1 = deriv(t, x);
+
+        // x + dt/2 * k1
+        AttitudeState xTemp;
+        for (std::size_t i = 0; i < 4; ++i) {
+            xTemp.q[i] = x.q[i] + 0.5 * dt * k1.q[i];
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            xTemp.w[i] = x.w[i] + 0.5 * dt * k1.w[i];
+            xTemp.h[i] = x.h[i] + 0.5 * dt * k1.h[i];
+        }
+        AttitudeState k2 = deriv(t + 0.5 * dt, xTemp);
+
+        // x + dt/2 * k2
+        for (std::size_t i = 0; i < 4; ++i) {
+            xTemp.q[i] = x.q[i] + 0.5 * dt * k2.q[i];
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            xTemp.w[i] = x.w[i] + 0.5 * dt * k2.w[i];
+            xTemp.h[i] = x.h[i] + 0.5 * dt * k2.h[i];
+        }
+        AttitudeState k3 = deriv(t + 0.5 * dt, xTemp);
+
+        // x + dt * k3
+        for (std::size_t i = 0; i < 4; ++i) {
+            xTemp.q[i] = x.q[i] + dt * k3.q[i];
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            xTemp.w[i] = x.w[i] + dt * k3.w[i];
+            xTemp.h[i] = x.h[i] + dt * k3.h[i];
+        }
+        AttitudeState k4 = deriv(t + dt, xTemp);
+
+        // Combine stages
+        AttitudeState xNext;
+        for (std::size_t i = 0; i < 4; ++i) {
+            xNext.q[i] = x.q[i] + (dt / 6.0) *
+                (k1.q[i] + 2.0 * k2.q[i] + 2.0 * k3.q[i] + k4.q[i]);
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            xNext.w[i] = x.w[i] + (dt / 6.0) *
+                (k1.w[i] + 2.0 * k2.w[i] + 2.0 * k3.w[i] + k4.w[i]);
+            xNext.h[i] = x.h[i] + (dt / 6.0) *
+                (k1.h[i] + 2.0 * k2.h[i] + 2.0 * k3.h[i] + k4.h[i]);
+        }
+
+        // Normalize quaternion to maintain unit norm
+        xNext.q = normalize(xNext.q);
+
+        return xNext;
+    }
+};
+
+// Integrator whose method is chosen at run time (AttitudeSimulation, tools).
+// Each step dispatches on the method; runSimulation uses StaticIntegrator.
+class Integrator : public IntegratorBase {
+public:
+    explicit Integrator(
+        IntegrationMethod method,
+        IntegratorTolerances tolerances = IntegratorTolerances{}
+    )
+        : IntegratorBase(tolerances),
+          method_(method)
+    {}
+
+    IntegrationMethod method() const { return method_; }
+    bool isAdaptive() const { return method_ == IntegrationMethod::RK45; }
+
+    // Advance x from t to t + dt with body torque tau held over the step
+    template <typename Dyn>
+    AttitudeState step(
+        const Dyn &dynamics,
         double t,
         const AttitudeState &x,
         double dt,
-        const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-    ) const;
+        const Vec3 &tau
+    ) const {
+        switch (method_) {
+        case IntegrationMethod::Euler:
+            return stepWith_<IntegrationMethod::Euler>(dynamics, t, x, dt, tau);
+        case IntegrationMethod::RKMK4:
+            return stepWith_<IntegrationMethod::RKMK4>(dynamics, t, x, dt, tau);
+        case IntegrationMethod::RK4:
+        default:
+            return stepWith_<IntegrationMethod::RK4>(dynamics, t, x, dt, tau);
+        }
+    }
+
+private:
+    IntegrationMethod method_;
+};
+
+// Integrator with the method fixed at compile time: step() is the method's
+// kernel itself, with no per-step dispatch, and isAdaptive() is a constant
+// the simulation loop folds away. Same interface as Integrator.
+template <IntegrationMethod Method>
+class StaticIntegrator : public IntegratorBase {
+public:
+    explicit StaticIntegrator(IntegratorTolerances tolerances = IntegratorTolerances{})
+        : IntegratorBase(tolerances)
+    {}
+
+    static constexpr IntegrationMethod method() { return Method; }
+    static constexpr bool isAdaptive() { return Method == IntegrationMethod::RK45; }
 
-    AttitudeState stepRK4_(
-        const AttitudeDynamics &dyn,
+    // Advance x from t to t + dt with body torque tau held over the step
+    template <typename Dyn>
+    AttitudeState step(
+        const Dyn &dynamics,
         double t,
         const AttitudeState &x,
         double dt,
-        const std::function<Vec3(double, const AttitudeState&)> &torqueFunc
-    ) const;
+        const Vec3 &tau
+    ) const {
+        return stepWith_<Method>(dynamics, t, x, dt, tau);
+    }
 };
 
 } // namespace starSense
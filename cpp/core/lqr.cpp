@@ -0,0 +1,241 @@
+#include "lqr.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace starSense {
+
+namespace {
+
+constexpr std::size_t kN = 6;        // state dimension
+constexpr std::size_t kH = 2 * kN;   // Hamiltonian dimension
+
+template <std::size_t R, std::size_t C>
+using Mat = std::array<std::array<double, C>, R>;
+
+// In-place Gauss–Jordan inverse with partial pivoting.
+// Returns false if A is numerically singular; logAbsDet receives log|det A|.
+template <std::size_t N>
+bool invertInPlace(Mat<N, N> &A, double &logAbsDet) {
+    std::array<std::size_t, N> perm;
+    for (std::size_t i = 0; i < N; ++i) {
+        perm[i] = i;
+    }
+    logAbsDet = 0.0;
+
+    for (std::size_t col = 0; col < N; ++col) {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < N; ++row) {
+            if (std::abs(A[row][col]) > std::abs(A[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (!(std::abs(A[pivot][col]) > 0.0)) {
+            return false;
+        }
+        std::swap(A[pivot], A[col]);
+        std::swap(perm[pivot], perm[col]);
+
+        const double diag = A[col][col];
+        logAbsDet += std::log(std::abs(diag));
+        const double invDiag = 1.0 / diag;
+        A[col][col] = 1.0;
+        for (std::size_t j = 0; j < N; ++j) {
+            A[col][j] *= invDiag;
+        }
+        for (std::size_t row = 0; row < N; ++row) {
+            if (row == col) {
+                continue;
+            }
+            const double f = A[row][col];
+            if (f == 0.0) {
+                continue;
+            }
+            A[row][col] = 0.0;
+            for (std::size_t j = 0; j < N; ++j) {
+                A[row][j] -= f * A[col][j];
+            }
+        }
+    }
+
+    // Undo the row permutation as a column permutation of the inverse
+    Mat<N, N> inv;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            inv[i][perm[j]] = A[i][j];
+        }
+    }
+    A = inv;
+    return std::isfinite(logAbsDet);
+}
+
+template <std::size_t R, std::size_t C>
+double norm1(const Mat<R, C> &A) {
+    double best = 0.0;
+    for (std::size_t j = 0; j < C; ++j) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < R; ++i) {
+            sum += std::abs(A[i][j]);
+        }
+        best = std::max(best, sum);
+    }
+    return best;
+}
+
+// Stabilizing solution P of A^T P + P A - P G P + Q = 0 (G = B R^{-1} B^T)
+// via the sign function of H = [A, -G; -Q, -A^T]. The stable invariant
+// subspace of H is null(sign(H) + I) = span([I; P]).
+Mat<kN, kN> solveCare(const Mat<kN, kN> &A, const Mat<kN, kN> &G, const Mat<kN, kN> &Q) {
+    Mat<kH, kH> Z{};
+    for (std::size_t i = 0; i < kN; ++i) {
+        for (std::size_t j = 0; j < kN; ++j) {
+            Z[i][j] = A[i][j];
+            Z[i][j + kN] = -G[i][j];
+            Z[i + kN][j] = -Q[i][j];
+            Z[i + kN][j + kN] = -A[j][i];
+        }
+    }
+
+    // Newton iteration Z <- (c Z + (c Z)^{-1}) / 2 with determinant scaling
+    // c = |det Z|^{-1/n}; scaling is dropped near convergence so the final
+    // steps stay quadratic.
+    constexpr int kMaxIterations = 100;
+    constexpr double kTol = 1e-13;
+    bool scale = true;
+    bool converged = false;
+    for (int it = 0; it < kMaxIterations && !converged; ++it) {
+        Mat<kH, kH> Zinv = Z;
+        double logAbsDet = 0.0;
+        if (!invertInPlace(Zinv, logAbsDet)) {
+            throw std::runtime_error(
+                "lqrAttitudeGain: Hamiltonian has eigenvalues on the imaginary axis");
+        }
+        const double c = scale ? std::exp(-logAbsDet / static_cast<double>(kH)) : 1.0;
+
+        double diff = 0.0;
+        for (std::size_t i = 0; i < kH; ++i) {
+            for (std::size_t j = 0; j < kH; ++j) {
+                const double next = 0.5 * (c * Z[i][j] + Zinv[i][j] / c);
+                diff = std::max(diff, std::abs(next - Z[i][j]));
+                Z[i][j] = next;
+            }
+        }
+
+        const double size = norm1(Z);
+        if (diff <= 1e-2 * size) {
+            scale = false;
+        }
+        converged = diff <= kTol * size;
+    }
+    if (!converged) {
+        throw std::runtime_error("lqrAttitudeGain: Riccati iteration did not converge");
+    }
+
+    // [W12; W22 + I] P = -[W11 + I; W21], solved in the least-squares sense
+    // through the 6x6 normal equations
+    Mat<kN, kN> MtM{};
+    Mat<kN, kN> MtN{};
+    for (std::size_t i = 0; i < kN; ++i) {
+        for (std::size_t j = 0; j < kN; ++j) {
+            double mm = 0.0;
+            double mn = 0.0;
+            for (std::size_t k = 0; k < kH; ++k) {
+                const double mki = Z[k][i + kN] + ((k == i + kN) ? 1.0 : 0.0);
+                const double mkj = Z[k][j + kN] + ((k == j + kN) ? 1.0 : 0.0);
+                const double nkj = -(Z[k][j] + ((k == j) ? 1.0 : 0.0));
+                mm += mki * mkj;
+                mn += mki * nkj;
+            }
+            MtM[i][j] = mm;
+            MtN[i][j] = mn;
+        }
+    }
+
+    double logAbsDet = 0.0;
+    if (!invertInPlace(MtM, logAbsDet)) {
+        throw std::runtime_error("lqrAttitudeGain: no stabilizing Riccati solution");
+    }
+
+    Mat<kN, kN> P{};
+    for (std::size_t i = 0; i < kN; ++i) {
+        for (std::size_t j = 0; j < kN; ++j) {
+            for (std::size_t k = 0; k < kN; ++k) {
+                P[i][j] += MtM[i][k] * MtN[k][j];
+            }
+        }
+    }
+
+    // Symmetrize to remove round-off asymmetry
+    for (std::size_t i = 0; i < kN; ++i) {
+        for (std::size_t j = i + 1; j < kN; ++j) {
+            const double s = 0.5 * (P[i][j] + P[j][i]);
+            P[i][j] = s;
+            P[j][i] = s;
+        }
+    }
+    return P;
+}
+
+} // namespace
+
+Mat3x6 lqrAttitudeGain(const Mat3 &inertia, const Vec3 &qAtt, const Vec3 &qRate, const Vec3 &r) {
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (!(qAtt[i] > 0.0) || !(qRate[i] >= 0.0) || !(r[i] > 0.0)) {
+            throw std::invalid_argument(
+                "lqrAttitudeGain: attitude and torque weights must be > 0, rate weights >= 0");
+        }
+    }
+
+    // A physical inertia is symmetric positive definite; checking the leading
+    // minors up front keeps a bad one an invalid_argument (and scale-free,
+    // unlike inverse()'s absolute determinant threshold)
+    const double m1 = inertia[0][0];
+    const double m2 = inertia[0][0] * inertia[1][1] - inertia[0][1] * inertia[1][0];
+    const double m3 =
+          inertia[0][0] * (inertia[1][1] * inertia[2][2] - inertia[1][2] * inertia[2][1])
+        - inertia[0][1] * (inertia[1][0] * inertia[2][2] - inertia[1][2] * inertia[2][0])
+        + inertia[0][2] * (inertia[1][0] * inertia[2][1] - inertia[1][1] * inertia[2][0]);
+    if (!(m1 > 0.0) || !(m2 > 0.0) || !(m3 > 0.0) || !std::isfinite(m3)) {
+        throw std::invalid_argument("lqrAttitudeGain: inertia must be positive definite");
+    }
+
+    Mat3 Jinv = inertia;
+    double logAbsDet = 0.0;
+    if (!invertInPlace(Jinv, logAbsDet)) {
+        throw std::invalid_argument("lqrAttitudeGain: inertia is singular");
+    }
+
+    // A = [0, I; 0, 0], B = [0; J^{-1}], G = B R^{-1} B^T, Q = diag(qAtt, qRate)
+    Mat<kN, kN> A{};
+    Mat<kN, kN> G{};
+    Mat<kN, kN> Q{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        A[i][i + 3] = 1.0;
+        Q[i][i] = qAtt[i];
+        Q[i + 3][i + 3] = qRate[i];
+        for (std::size_t j = 0; j < 3; ++j) {
+            double g = 0.0;
+            for (std::size_t k = 0; k < 3; ++k) {
+                g += Jinv[i][k] * Jinv[j][k] / r[k];
+            }
+            G[i + 3][j + 3] = g;
+        }
+    }
+
+    const Mat<kN, kN> P = solveCare(A, G, Q);
+
+    // K = R^{-1} B^T P = R^{-1} J^{-T} P[3:6, :]
+    Mat3x6 K{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < kN; ++j) {
+            double s = 0.0;
+            for (std::size_t k = 0; k < 3; ++k) {
+                s += Jinv[k][i] * P[k + 3][j];
+            }
+            K[i][j] = s / r[i];
+        }
+    }
+    return K;
+}
+
+} // namespace starSense
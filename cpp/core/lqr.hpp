@@ -0,0 +1,34 @@
+#pragma once
+
+#include "util.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Continuous-time LQR gain for the attitude error model
+//
+//   x = [phi; e_w]          (attitude error, rate error)
+//   phi_dot = e_w
+//   e_w_dot = J^{-1} tau    (w_ref = 0, gyroscopic cross-terms ignored)
+//
+//   cost = ∫ (x^T Q x + tau^T R tau) dt,  Q = diag(qAtt, qRate), R = diag(r)
+//
+// Returns K (3x6) such that tau = -K x, the gain LQRController expects.
+// Same model as python/lqr_utils.py::build_lqr_gain, solved natively.
+//
+// The Riccati equation is solved with the matrix sign function of the 12x12
+// Hamiltonian (scaled Newton iteration), which only needs fixed-size
+// inversions and costs a few microseconds per gain.
+//
+// Throws std::invalid_argument for non-positive qAtt or r, negative qRate or
+// an inertia that is not positive definite, and std::runtime_error if the
+// iteration fails.
+// ----------------------------------------------------------
+Mat3x6 lqrAttitudeGain(
+    const Mat3 &inertia,
+    const Vec3 &qAtt,
+    const Vec3 &qRate,
+    const Vec3 &r
+);
+
+} // namespace starSense
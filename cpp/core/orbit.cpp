@@ -0,0 +1,89 @@
+#include "orbit.hpp"
+
+#include <stdexcept>
+
+namespace starSense {
+
+KeplerOrbit::KeplerOrbit(const OrbitElements &elements, bool j2)
+    : el_(elements)
+{
+    if (!(el_.semiMajorAxis > 0.0) || el_.eccentricity < 0.0 || el_.eccentricity >= 1.0) {
+        throw std::invalid_argument(
+            "KeplerOrbit: semiMajorAxis must be > 0 and 0 <= eccentricity < 1");
+    }
+    if (el_.semiMajorAxis * (1.0 - el_.eccentricity) < kEarthRadius) {
+        throw std::invalid_argument("KeplerOrbit: perigee is below the Earth's surface");
+    }
+
+    const double a = el_.semiMajorAxis;
+    const double e = el_.eccentricity;
+    n_ = std::sqrt(kEarthMu / (a * a * a));
+
+    raanRate_ = 0.0;
+    argPerigeeRate_ = 0.0;
+    meanAnomalyRate_ = n_;
+    if (j2) {
+        // Secular rates (Vallado, "Fundamentals of Astrodynamics", 9-41)
+        const double p = a * (1.0 - e * e);
+        const double k = 0.75 * n_ * kEarthJ2 * (kEarthRadius / p) * (kEarthRadius / p);
+        const double ci = std::cos(el_.inclination);
+        raanRate_ = -2.0 * k * ci;
+        argPerigeeRate_ = k * (5.0 * ci * ci - 1.0);
+        meanAnomalyRate_ += k * std::sqrt(1.0 - e * e) * (3.0 * ci * ci - 1.0);
+    }
+}
+
+OrbitState KeplerOrbit::state(double t) const {
+    const double a = el_.semiMajorAxis;
+    const double e = el_.eccentricity;
+    const double raan = el_.raan + raanRate_ * t;
+    const double argp = el_.argPerigee + argPerigeeRate_ * t;
+    const double M = std::remainder(el_.meanAnomaly + meanAnomalyRate_ * t, 2.0 * M_PI);
+
+    // Kepler's equation M = E - e sin E (Newton; converges in a few
+    // iterations for e < 1 from this start)
+    double E = (e < 0.8) ? M : M_PI * (M >= 0.0 ? 1.0 : -1.0);
+    for (int it = 0; it < 20; ++it) {
+        const double dE = (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+        E -= dE;
+        if (std::abs(dE) < 1e-14) {
+            break;
+        }
+    }
+
+    // Perifocal position and velocity
+    const double cE = std::cos(E);
+    const double sE = std::sin(E);
+    const double b = a * std::sqrt(1.0 - e * e);
+    const double rNorm = a * (1.0 - e * cE);
+    const double xP = a * (cE - e);
+    const double yP = b * sE;
+    const double Edot = meanAnomalyRate_ * a / rNorm;
+    const double vxP = -a * Edot * sE;
+    const double vyP = b * Edot * cE;
+
+    // Perifocal -> ECI: R3(-raan) R1(-i) R3(-argp), first two columns
+    const double cO = std::cos(raan), sO = std::sin(raan);
+    const double cw = std::cos(argp), sw = std::sin(argp);
+    const double ci = std::cos(el_.inclination), si = std::sin(el_.inclination);
+    const Vec3 P{cO * cw - sO * sw * ci, sO * cw + cO * sw * ci, sw * si};
+    const Vec3 Q{-cO * sw - sO * cw * ci, -sO * sw + cO * cw * ci, cw * si};
+
+    OrbitState s;
+    for (std::size_t i = 0; i < 3; ++i) {
+        s.r[i] = xP * P[i] + yP * Q[i];
+        s.v[i] = vxP * P[i] + vyP * Q[i];
+    }
+
+    // Velocity of the rotating perifocal frame (J2 perigee and node drift)
+    const Vec3 hHat = cross(P, Q);
+    const Vec3 wFrame{
+        argPerigeeRate_ * hHat[0],
+        argPerigeeRate_ * hHat[1],
+        argPerigeeRate_ * hHat[2] + raanRate_
+    };
+    s.v = add(s.v, cross(wFrame, s.r));
+    return s;
+}
+
+} // namespace starSense
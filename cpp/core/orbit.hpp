@@ -0,0 +1,50 @@
+#pragma once
+
+#include "types.hpp"
+#include "util.hpp"
+
+namespace starSense {
+
+// Earth constants (WGS-84 / EGM-96)
+constexpr double kEarthMu = 3.986004418e14;        // gravitational parameter [m³/s²]
+constexpr double kEarthRadius = 6378137.0;         // equatorial radius [m]
+constexpr double kEarthJ2 = 1.08262668e-3;         // second zonal harmonic
+constexpr double kEarthRotationRate = 7.2921159e-5; // sidereal rotation rate [rad/s]
+
+// Classical orbital elements at t = 0 (angles in radians)
+struct OrbitElements {
+    double semiMajorAxis = 6778137.0;  // [m] (400 km circular)
+    double eccentricity = 0.0;
+    double inclination = 0.9;          // ≈ 51.6°
+    double raan = 0.0;                 // right ascension of the ascending node
+    double argPerigee = 0.0;
+    double meanAnomaly = 0.0;
+};
+
+// Position and velocity in the Earth-centred inertial frame
+struct OrbitState {
+    Vec3 r;  // [m]
+    Vec3 v;  // [m/s]
+};
+
+// Keplerian orbit with optional secular J2 drift of the node, perigee and
+// mean anomaly (no short-period terms, no drag decay). Cheap enough to
+// evaluate at the environment update rate; a pure function of t, so one
+// propagator can serve concurrent runs.
+class KeplerOrbit {
+public:
+    explicit KeplerOrbit(const OrbitElements &elements, bool j2 = true);
+
+    OrbitState state(double t) const;
+
+    double meanMotion() const { return n_; }
+
+private:
+    OrbitElements el_;
+    double n_;          // Keplerian mean motion [rad/s]
+    double raanRate_;   // secular J2 rates [rad/s]
+    double argPerigeeRate_;
+    double meanAnomalyRate_;
+};
+
+} // namespace starSense
@@ -0,0 +1,83 @@
+#include "parallel.hpp"
+
+#include <stdexcept>
+
+namespace starSense {
+
+ThreadPool::ThreadPool(int numThreads) {
+    const std::size_t count = resolveWorkerCount(numThreads, std::numeric_limits<std::size_t>::max());
+    workers_.reserve(count);
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this]() { workerLoop_(); });
+        }
+    } catch (...) {
+        // Destroying a joinable std::thread terminates the process, so stop
+        // and join the workers already started before reporting the error
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        taskReady_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskReady_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return tasks_.empty() && running_ == 0; });
+}
+
+void ThreadPool::enqueue_(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw std::runtime_error("ThreadPool: submit after shutdown");
+        }
+        tasks_.push_back(std::move(task));
+    }
+    taskReady_.notify_one();
+}
+
+void ThreadPool::workerLoop_() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskReady_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;  // stopping and drained
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++running_;
+        }
+
+        // Tasks from submit() capture their own exceptions in the future
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+            if (tasks_.empty() && running_ == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace starSense
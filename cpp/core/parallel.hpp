@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace starSense {
+
+// Resolve a requested worker count.
+//  numThreads <= 0 : one worker per hardware thread
+//  never more workers than there are tasks, never fewer than one
+inline std::size_t resolveWorkerCount(int numThreads, std::size_t numTasks) {
+    std::size_t workers = (numThreads > 0)
+        ? static_cast<std::size_t>(numThreads)
+        : static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+    workers = std::max<std::size_t>(workers, 1);
+    return std::min(workers, std::max<std::size_t>(numTasks, 1));
+}
+
+// Run fn(worker, i) for every i in [0, count) on a pool of worker threads,
+// where worker in [0, resolveWorkerCount(numThreads, count)) identifies the
+// thread running the task. Use it to index per-worker state (accumulators)
+// that needs no locking and is merged once the loop returns.
+//
+// Indices are handed out one at a time from a shared counter, so cases of
+// very different length still balance across workers. The calling thread
+// works too, as worker 0. If any task throws, no new indices are handed out
+// and the first exception is rethrown on the calling thread once every
+// worker has joined. If the system refuses to start another thread (thread
+// or process limits), the loop runs on the workers already started.
+template <typename Fn>
+void parallelForWorkers(std::size_t count, int numThreads, Fn &&fn) {
+    const std::size_t numWorkers = resolveWorkerCount(numThreads, count);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&](std::size_t workerId) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) {
+                break;
+            }
+            try {
+                fn(workerId, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numWorkers - 1);
+    try {
+        for (std::size_t w = 1; w < numWorkers; ++w) {
+            threads.emplace_back(worker, w);
+        }
+    } catch (...) {
+        // Fewer workers only slows the loop; the calling thread always runs
+    }
+    worker(0);
+
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+// Run fn(i) for every i in [0, count) on a pool of worker threads (see
+// parallelForWorkers)
+template <typename Fn>
+void parallelFor(std::size_t count, int numThreads, Fn &&fn) {
+    parallelForWorkers(count, numThreads, [&fn](std::size_t, std::size_t i) { fn(i); });
+}
+
+// Fixed-size pool of worker threads consuming a FIFO task queue.
+//
+// Unlike parallelFor, which blocks until a known set of indices is done,
+// the pool accepts work at any time and returns a std::future per task.
+// The destructor finishes every queued task before joining the workers.
+class ThreadPool {
+public:
+    //  numThreads : worker count (<= 0 uses one per hardware thread)
+    // Throws std::system_error if a worker thread cannot be started
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Queue fn() and return a future for its result (or exception)
+    template <typename Fn>
+    auto submit(Fn &&fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using R = std::invoke_result_t<std::decay_t<Fn>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Fn>(fn));
+        std::future<R> future = task->get_future();
+        enqueue_([task]() { (*task)(); });
+        return future;
+    }
+
+    // Block until the queue is empty and no task is running
+    void waitIdle();
+
+    std::size_t size() const { return workers_.size(); }
+
+private:
+    void enqueue_(std::function<void()> task);
+    void workerLoop_();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskReady_;
+    std::condition_variable idle_;
+    std::size_t running_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace starSense
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Philox4x32-10 counter-based random number generator
+// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11)
+//
+// A sample is a pure function of (key, counter): there is no generator
+// state to share, lock or advance, so any worker can produce any sample and
+// results never depend on thread count or scheduling. Within starSense the
+// key is (seed, caseId) and the counter is (sample index, stream).
+// ----------------------------------------------------------
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+namespace detail {
+
+inline void philoxMulHiLo(std::uint32_t a, std::uint32_t b, std::uint32_t &hi, std::uint32_t &lo) {
+    const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    hi = static_cast<std::uint32_t>(product >> 32);
+    lo = static_cast<std::uint32_t>(product);
+}
+
+} // namespace detail
+
+// One Philox4x32-10 block: four independent 32-bit outputs
+inline PhiloxCounter philox4x32(PhiloxCounter ctr, PhiloxKey key) {
+    constexpr std::uint32_t M0 = 0xD2511F53u;
+    constexpr std::uint32_t M1 = 0xCD9E8D57u;
+    constexpr std::uint32_t W0 = 0x9E3779B9u;
+    constexpr std::uint32_t W1 = 0xBB67AE85u;
+
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += W0;
+            key[1] += W1;
+        }
+        std::uint32_t hi0, lo0, hi1, lo1;
+        detail::philoxMulHiLo(M0, ctr[0], hi0, lo0);
+        detail::philoxMulHiLo(M1, ctr[2], hi1, lo1);
+        ctr = PhiloxCounter{hi1 ^ ctr[1] ^ key[0], lo1, hi0 ^ ctr[3] ^ key[1], lo0};
+    }
+    return ctr;
+}
+
+// Key for one Monte Carlo case
+inline PhiloxKey philoxKey(std::uint32_t seed, std::uint32_t caseId) {
+    return PhiloxKey{seed, caseId};
+}
+
+// Counter for sample `index` of noise `stream`
+inline PhiloxCounter philoxCounter(std::uint64_t index, std::uint32_t stream) {
+    return PhiloxCounter{
+        static_cast<std::uint32_t>(index),
+        static_cast<std::uint32_t>(index >> 32),
+        stream,
+        0u
+    };
+}
+
+// Uniform on the open interval (0, 1)
+inline double uniformOpen01(std::uint32_t x) {
+    return (static_cast<double>(x) + 0.5) * (1.0 / 4294967296.0);
+}
+
+// Four independent standard normals for (key, index, stream) (Box–Muller)
+inline std::array<double, 4> philoxNormals(PhiloxKey key, std::uint64_t index, std::uint32_t stream) {
+    constexpr double kTwoPi = 6.283185307179586;
+    const PhiloxCounter bits = philox4x32(philoxCounter(index, stream), key);
+
+    const double r0 = std::sqrt(-2.0 * std::log(uniformOpen01(bits[0])));
+    const double a0 = kTwoPi * uniformOpen01(bits[1]);
+    const double r1 = std::sqrt(-2.0 * std::log(uniformOpen01(bits[2])));
+    const double a1 = kTwoPi * uniformOpen01(bits[3]);
+
+    return {r0 * std::cos(a0), r0 * std::sin(a0), r1 * std::cos(a1), r1 * std::sin(a1)};
+}
+
+// Block form: out[4*j .. 4*j+3] = philoxNormals(key, first + j, stream) for
+// j in [0, count). Iterations are independent, so blocks can be generated
+// in any order, split across threads or vectorized.
+inline void fillPhiloxNormals(
+    PhiloxKey key,
+    std::uint32_t stream,
+    std::uint64_t first,
+    std::size_t count,
+    double *out
+) {
+    for (std::size_t j = 0; j < count; ++j) {
+        const std::array<double, 4> n = philoxNormals(key, first + j, stream);
+        out[4 * j + 0] = n[0];
+        out[4 * j + 1] = n[1];
+        out[4 * j + 2] = n[2];
+        out[4 * j + 3] = n[3];
+    }
+}
+
+} // namespace starSense
@@ -17,7 +17,7 @@ public:
     virtual ReferenceState computeReferenceState(double t, AttitudeState estimatedState) const = 0;
 };
 
-class ConstantReferenceProfile : public ReferenceProfile {
+class ConstantReferenceProfile final : public ReferenceProfile {
 public:
     explicit ConstantReferenceProfile(const Quat& qRef0)
         : qRef0_(qRef0) {}
@@ -30,7 +30,7 @@ private:
     const Quat qRef0_;
 };
 
-class SpinningReferenceProfile : public ReferenceProfile {
+class SpinningReferenceProfile final : public ReferenceProfile {
 public:
     explicit SpinningReferenceProfile(const Vec3 wRef0) 
         : wRef0_(wRef0) {}
@@ -0,0 +1,34 @@
+#include "scheduler.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace starSense {
+
+MultiRateScheduler::MultiRateScheduler(const TaskPeriods &periods)
+    : periods_(periods)
+{
+    if (periods_.sensor < 0 || periods_.controller < 0 || periods_.actuator < 0) {
+        throw std::invalid_argument("MultiRateScheduler: task periods must be >= 0");
+    }
+}
+
+int MultiRateScheduler::periodFromRate(double rateHz, double dt, const char *name) {
+    if (!(rateHz > 0.0)) {
+        return 1;
+    }
+
+    // Ticks per task period, which must be a whole number (up to rounding
+    // in the decimal rate and step)
+    const double ticks = 1.0 / (rateHz * dt);
+    const double period = std::round(ticks);
+    if (period < 1.0 || period > 2147483647.0 || std::abs(ticks - period) > 1e-9 * period) {
+        throw std::invalid_argument(
+            std::string("MultiRateScheduler: 1 / ") + name + " = " + std::to_string(1.0 / rateHz) +
+            " s must be a whole number of base steps dt = " + std::to_string(dt) + " s");
+    }
+    return static_cast<int>(period);
+}
+
+} // namespace starSense
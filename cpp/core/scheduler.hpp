@@ -0,0 +1,55 @@
+#pragma once
+
+#include <limits>
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Multi-rate task schedule
+//
+// Simulation time advances in integer ticks of the base step dt
+// (t_k = k * dt). Each task runs on the ticks that are multiples of its
+// period, so task rates are exact and never drift however long the run.
+// A task that is not due on a tick is not called at all; its last output is
+// held until it next runs.
+// ----------------------------------------------------------
+
+// Period of each task in ticks of dt (0: run once, on tick 0)
+struct TaskPeriods {
+    int sensor = 1;      // measurement and estimator update
+    int controller = 1;  // reference and control law
+    int actuator = 1;    // command to applied torque (the only task that changes it)
+};
+
+class MultiRateScheduler {
+public:
+    explicit MultiRateScheduler(const TaskPeriods &periods);
+
+    bool sensorDue(int k) const { return due(periods_.sensor, k); }
+    bool controllerDue(int k) const { return due(periods_.controller, k); }
+    bool actuatorDue(int k) const { return due(periods_.actuator, k); }
+
+    // First tick after k on which the actuator runs (INT_MAX: never)
+    int nextActuatorTick(int k) const {
+        const int p = periods_.actuator;
+        return (p > 0) ? (k / p + 1) * p : std::numeric_limits<int>::max();
+    }
+
+    // Period in ticks of a task running at rateHz on base step dt; rateHz <= 0
+    // runs it every tick. Throws std::invalid_argument unless 1/rateHz is a
+    // whole number of base steps. `name` labels the error message.
+    static int periodFromRate(double rateHz, double dt, const char *name);
+
+private:
+    // Period 1 (the default) skips the division on every tick
+    static bool due(int period, int k) {
+        if (period == 1) {
+            return true;
+        }
+        return (period > 0) ? (k % period == 0) : (k == 0);
+    }
+
+    TaskPeriods periods_;
+};
+
+} // namespace starSense
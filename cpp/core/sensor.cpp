@@ -1,15 +1,81 @@
 #include "sensor.hpp"
 
+#include <stdexcept>
+
 namespace starSense {
 
-Quat IdealAttitudeSensor::measureAttitude(
+AttitudeState IdealAttitudeSensor::measure(
     double t,
-    const AttitudeState &trueState
+    const AttitudeState &trueState,
+    SensorState &state
 ) const {
-    (void)t;  // unused in ideal model
+    (void)t;      // unused in ideal model
+    (void)state;
+
+    // Perfect measurement: return true attitude and rate
+    return trueState;
+}
+
+
+// NoisyAttitudeSensor
+NoisyAttitudeSensor::NoisyAttitudeSensor(const NoisySensorParams &params)
+    : params_(params),
+      key_(philoxKey(params.seed, params.caseId))
+{
+    if (params_.starTrackerNoise < 0.0 || params_.gyroNoise < 0.0 || params_.gyroBiasRandomWalk < 0.0) {
+        throw std::invalid_argument("NoisyAttitudeSensor: noise levels must be >= 0");
+    }
+}
+
+SensorState NoisyAttitudeSensor::initialState() const {
+    SensorState state;
+    state.gyroBias = params_.gyroBias0;
+    return state;
+}
+
+AttitudeState NoisyAttitudeSensor::measure(
+    double t,
+    const AttitudeState &trueState,
+    SensorState &state
+) const {
+    const std::uint64_t n = state.sampleIndex++;
+
+    // Gyro bias random walk over the time since the previous measurement
+    if (params_.gyroBiasRandomWalk > 0.0 && state.lastTime >= 0.0 && t > state.lastTime) {
+        const std::array<double, 4> g = philoxNormals(key_, n, kStreamGyroBias);
+        const double sigma = params_.gyroBiasRandomWalk * std::sqrt(t - state.lastTime);
+        for (std::size_t i = 0; i < 3; ++i) {
+            state.gyroBias[i] += sigma * g[i];
+        }
+    }
+    state.lastTime = t;
+
+    AttitudeState measured = trueState;
+
+    // Star tracker: q_meas = q ⊗ exp(bias + noise)
+    Vec3 dTheta = params_.starTrackerBias;
+    if (params_.starTrackerNoise > 0.0) {
+        const std::array<double, 4> g = philoxNormals(key_, n, kStreamStarTracker);
+        for (std::size_t i = 0; i < 3; ++i) {
+            dTheta[i] += params_.starTrackerNoise * g[i];
+        }
+    }
+    if (dTheta[0] != 0.0 || dTheta[1] != 0.0 || dTheta[2] != 0.0) {
+        measured.q = normalize(quatMultiply(trueState.q, quatFromRotationVector(dTheta)));
+    }
+
+    // Gyro: w_meas = w + bias + noise
+    for (std::size_t i = 0; i < 3; ++i) {
+        measured.w[i] += state.gyroBias[i];
+    }
+    if (params_.gyroNoise > 0.0) {
+        const std::array<double, 4> g = philoxNormals(key_, n, kStreamGyro);
+        for (std::size_t i = 0; i < 3; ++i) {
+            measured.w[i] += params_.gyroNoise * g[i];
+        }
+    }
 
-    // Perfect measurement: return true attitude
-    return trueState.q;
+    return measured;
 }
 
 } // namespace starSense
@@ -1,36 +1,94 @@
 #pragma once
 
+#include <cstdint>
+
 #include "types.hpp"
+#include "util.hpp"
+#include "random.hpp"
 
 namespace starSense {
 
+// Per-run sensor state (noise counters, drifting biases).
+// Owned by the simulation run rather than the sensor, so one configured
+// sensor can serve many runs back-to-back or concurrently.
+struct SensorState {
+    std::uint64_t sampleIndex = 0;  // measurements taken so far (RNG counter)
+    Vec3 gyroBias{0.0, 0.0, 0.0};   // current gyro bias [rad/s]
+    double lastTime = -1.0;         // time of previous measurement (< 0: none yet)
+};
+
 // Abstract sensor interface
 class Sensor {
 public:
     virtual ~Sensor() = default;
 
-    // Measure attitude from the true state.
+    // State at the start of a run
+    virtual SensorState initialState() const { return SensorState{}; }
+
+    // Measure attitude and body rate from the true state.
     //
     // t          : current simulation time [s]
     // trueState  : true attitude state (q, w)
+    // state      : per-run sensor state, updated in place
     //
     // Returns:
-    //   measured quaternion (body wrt inertial)
-    virtual Quat measureAttitude(
+    //   measured state: star tracker quaternion (body wrt inertial) and
+    //   gyro rate (body frame) [rad/s]
+    virtual AttitudeState measure(
         double t,
-        const AttitudeState &trueState
+        const AttitudeState &trueState,
+        SensorState &state
     ) const = 0;
 };
 
 
 // Release 1: Ideal attitude sensor
-// No noise, no bias, no latency: just returns the true quaternion.
-class IdealAttitudeSensor : public Sensor {
+// No noise, no bias, no latency: just returns the true state.
+class IdealAttitudeSensor final : public Sensor {
+public:
+    AttitudeState measure(
+        double t,
+        const AttitudeState &trueState,
+        SensorState &state
+    ) const override;
+};
+
+
+// Star tracker + gyro with white noise, fixed misalignment and a gyro bias
+// random walk. Noise comes from Philox keyed by (seed, caseId) with the
+// measurement index as counter, so a case reproduces bit for bit no matter
+// which thread runs it or in what order.
+struct NoisySensorParams {
+    std::uint32_t seed = 0;
+    std::uint32_t caseId = 0;
+    double starTrackerNoise = 0.0;           // 1σ per axis [rad]
+    Vec3 starTrackerBias{0.0, 0.0, 0.0};     // fixed misalignment (rotation vector) [rad]
+    double gyroNoise = 0.0;                  // 1σ per axis per sample [rad/s]
+    Vec3 gyroBias0{0.0, 0.0, 0.0};           // initial gyro bias [rad/s]
+    double gyroBiasRandomWalk = 0.0;         // bias drift density [rad/s/√s]
+};
+
+class NoisyAttitudeSensor final : public Sensor {
 public:
-    Quat measureAttitude(
+    explicit NoisyAttitudeSensor(const NoisySensorParams &params);
+
+    // Gyro bias starts at gyroBias0
+    SensorState initialState() const override;
+
+    AttitudeState measure(
         double t,
-        const AttitudeState &trueState
+        const AttitudeState &trueState,
+        SensorState &state
     ) const override;
+
+private:
+    // Philox streams, one per independent noise source
+    static constexpr std::uint32_t kStreamStarTracker = 0;
+    static constexpr std::uint32_t kStreamGyro = 1;
+    static constexpr std::uint32_t kStreamGyroBias = 2;
+
+    NoisySensorParams params_;
+    PhiloxKey key_;
 };
 
 } // namespace starSense
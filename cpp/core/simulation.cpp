@@ -1,5 +1,8 @@
 #include <simulation.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace starSense {
 
 AttitudeSimulation::AttitudeSimulation(
@@ -8,112 +11,108 @@ AttitudeSimulation::AttitudeSimulation(
     std::unique_ptr<Controller> controller,
     std::unique_ptr<Sensor> sensor,
     std::unique_ptr<Actuator> actuator,
-    std::unique_ptr<ReferenceProfile> referenceProfile
+    std::unique_ptr<ReferenceProfile> referenceProfile,
+    std::unique_ptr<Estimator> estimator
 )
     : dynamics_(std::move(dynamics)),
       integrator_(std::move(integrator)),
       controller_(std::move(controller)),
       sensor_(std::move(sensor)),
       actuator_(std::move(actuator)),
-      referenceProfile_(std::move(referenceProfile))
+      referenceProfile_(std::move(referenceProfile)),
+      estimator_(estimator ? std::move(estimator) : std::make_unique<PassThroughEstimator>())
 {}
 
 SimulationResult AttitudeSimulation::run(
     const SimulationConfig &cfg,
     const AttitudeState &x0
 ) const {
-    SimulationResult result;
-    const int nSteps = cfg.numSteps;    
-    const double t0 = 0;  // always start from t = 0
-    const double dt = cfg.dt;
-
-    // Reserve memory
-    result.time.reserve(nSteps + 1);
-    result.commandedTorque.reserve(nSteps);
-    result.appliedTorque.reserve(nSteps);
-    result.qRef.reserve(nSteps + 1);
-    result.wRef.reserve(nSteps + 1);
-    result.attitudeError.reserve(nSteps + 1);
-    result.rateError.reserve(nSteps + 1);
-
-    // torqueFunc: sensor -> controller -> actuator -> tau_body
-    auto torqueFunc = [this, &result](double t, const AttitudeState &x) -> Vec3 {
-        // 1. sensor measurement 
-        Quat qMeas = sensor_->measureAttitude(t, x);
-
-        // estimated state = true state but with measured attitude
-        AttitudeState estimatedState = x;
-        estimatedState.q = qMeas; 
-
-        // 2. reference state (desired attitude / rate at time t)
-        ReferenceState ref = referenceProfile_->computeReferenceState(t, estimatedState);
-
-        // 3. controller: compute commanded torque in body frame
-        Vec3 commanded = controller_->computeCommandTorque(t, estimatedState, ref);
-
-        // 4. actuator: apply command, get actual applied torque
-        Vec3 applied = actuator_->applyCommand(t, x, commanded);
-
-        // 5. log torques for this step
-        result.commandedTorque.push_back(commanded);
-        result.appliedTorque.push_back(applied);
-
-        // this is what the dynamics sees
-        return applied;
-    };
-
-    // integrate dynamics
-    std::vector<AttitudeState> stateHistory = integrator_->integrate(
+    // Instantiated with the abstract interfaces: every component call is a
+    // virtual call. runSimulation uses StaticAttitudeSimulation instead.
+    return simulateAttitude(
         *dynamics_,
-        t0,
-        x0,
-        dt,
-        nSteps,
-        torqueFunc
+        *integrator_,
+        *controller_,
+        *sensor_,
+        *estimator_,
+        *actuator_,
+        *referenceProfile_,
+        cfg,
+        x0
     );
+}
 
-    // populate time, state, and extended logs
-    for (int k = 0; k <= nSteps; ++k) {
-        double tk      = t0 + static_cast<double>(k) * dt;
-        const auto &xk = stateHistory[k];
-
-        // state
-        result.time.push_back(tk);
-        result.quats.push_back(xk.q);
-        result.omegas.push_back(xk.w);
-
-        // reference at this grid time
-        ReferenceState ref = referenceProfile_->computeReferenceState(tk, AttitudeState{xk.q, xk.w});
-        result.qRef.push_back(ref.qRef);
-        result.wRef.push_back(ref.wRef);
-
-        // attitude error: q_err = q_ref^{-1} ⊗ q
-        Quat qRefConj = quatConjugate(ref.qRef);
-        Quat qErr     = quatMultiply(qRefConj, xk.q);
-
-        double qw = qErr[0];
-        Vec3 qv   = { qErr[1], qErr[2], qErr[3] };
-
-        double sign_qw = (qw >= 0.0) ? 1.0 : -1.0;
-
-        Vec3 eAtt = {
-            2.0 * sign_qw * qv[0],
-            2.0 * sign_qw * qv[1],
-            2.0 * sign_qw * qv[2]
-        };
+void computeDerivedChannels(SimulationResult &log, std::size_t firstRow, const Mat3 &inertia) {
+    const std::size_t rows = log.time.size();
+    if (firstRow >= rows) {
+        return;
+    }
+    const std::size_t count = rows - firstRow;
+
+    log.eulerAngles.data.resize(rows * 3);
+    log.attitudeErrorNorm.resize(rows);
+    log.rateErrorNorm.resize(rows);
+    log.kineticEnergy.resize(rows);
+    log.angularMomentum.data.resize(rows * 3);
+
+    const double *q = log.quats.data.data() + firstRow * 4;
+    const double *w = log.omegas.data.data() + firstRow * 3;
+    const double *h = log.wheelMomentum.data.data() + firstRow * 3;
+    const double *eAtt = log.attitudeError.data.data() + firstRow * 3;
+    const double *eRate = log.rateError.data.data() + firstRow * 3;
+    double *euler = log.eulerAngles.data.data() + firstRow * 3;
+    double *attNorm = log.attitudeErrorNorm.data() + firstRow;
+    double *rateNorm = log.rateErrorNorm.data() + firstRow;
+    double *energy = log.kineticEnergy.data() + firstRow;
+    double *momentum = log.angularMomentum.data.data() + firstRow * 3;
+
+    for (std::size_t r = 0; r < count; ++r) {
+        const double *e = eAtt + 3 * r;
+        attNorm[r] = std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+    }
+    for (std::size_t r = 0; r < count; ++r) {
+        const double *e = eRate + 3 * r;
+        rateNorm[r] = std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+    }
 
-        // rate error: ω − ω_ref
-        Vec3 eW = {
-            xk.w[0] - ref.wRef[0],
-            xk.w[1] - ref.wRef[1],
-            xk.w[2] - ref.wRef[2]
-        };
+    // Body momentum J ω + h; energy 1/2 ω·Jω
+    for (std::size_t r = 0; r < count; ++r) {
+        const double *wr = w + 3 * r;
+        double Jw[3];
+        for (std::size_t i = 0; i < 3; ++i) {
+            Jw[i] = inertia[i][0] * wr[0] + inertia[i][1] * wr[1] + inertia[i][2] * wr[2];
+        }
+        energy[r] = 0.5 * (wr[0] * Jw[0] + wr[1] * Jw[1] + wr[2] * Jw[2]);
+        for (std::size_t i = 0; i < 3; ++i) {
+            momentum[3 * r + i] = Jw[i] + h[3 * r + i];
+        }
+    }
 
-        result.attitudeError.push_back(eAtt);
-        result.rateError.push_back(eW);
+    // Rotate the momentum to the inertial frame with R(q) (q maps body to
+    // inertial), in place
+    for (std::size_t r = 0; r < count; ++r) {
+        const double qw = q[4 * r + 0], qx = q[4 * r + 1], qy = q[4 * r + 2], qz = q[4 * r + 3];
+        const double bx = momentum[3 * r + 0], by = momentum[3 * r + 1], bz = momentum[3 * r + 2];
+        momentum[3 * r + 0] = (1.0 - 2.0 * (qy * qy + qz * qz)) * bx
+                            + 2.0 * (qx * qy - qw * qz) * by
+                            + 2.0 * (qx * qz + qw * qy) * bz;
+        momentum[3 * r + 1] = 2.0 * (qx * qy + qw * qz) * bx
+                            + (1.0 - 2.0 * (qx * qx + qz * qz)) * by
+                            + 2.0 * (qy * qz - qw * qx) * bz;
+        momentum[3 * r + 2] = 2.0 * (qx * qz - qw * qy) * bx
+                            + 2.0 * (qy * qz + qw * qx) * by
+                            + (1.0 - 2.0 * (qx * qx + qy * qy)) * bz;
     }
 
-    return result;
+    // Extrinsic x-y-z angles of R(q) = Rz(yaw) Ry(pitch) Rx(roll), the
+    // convention of SciPy's as_euler("xyz")
+    for (std::size_t r = 0; r < count; ++r) {
+        const double qw = q[4 * r + 0], qx = q[4 * r + 1], qy = q[4 * r + 2], qz = q[4 * r + 3];
+        const double sinPitch = std::clamp(2.0 * (qw * qy - qx * qz), -1.0, 1.0);
+        euler[3 * r + 0] = std::atan2(2.0 * (qy * qz + qw * qx), 1.0 - 2.0 * (qx * qx + qy * qy));
+        euler[3 * r + 1] = std::asin(sinPitch);
+        euler[3 * r + 2] = std::atan2(2.0 * (qx * qy + qw * qz), 1.0 - 2.0 * (qy * qy + qz * qz));
+    }
 }
 
-}
\ No newline at end of file
+}
@@ -1,36 +1,650 @@
 #pragma once
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <vector>
-#include <functional>
 
 #include "types.hpp"
 #include "dynamics.hpp"
 #include "integrator.hpp"
 #include "sensor.hpp"
+#include "estimator.hpp"
 #include "actuator.hpp"
 #include "controller.hpp"
+#include "referenceProfile.hpp"
+#include "scheduler.hpp"
+#include "events.hpp"
+#include "summary.hpp"
 
 namespace starSense {
 
+struct SimulationResult;
+
+// Receives logged samples in fixed-size chunks while a run is in progress
+using ResultSink = std::function<void(const SimulationResult &chunk)>;
+
+// Which grid samples are logged and where they go.
+//
+// Samples t_k = k*dt with k % decimation == 0 are logged, plus the final
+// sample k = N so the end state is always available. Without a sink they
+// accumulate in the returned SimulationResult. With a sink they are handed
+// over in chunks of chunkSize rows and the returned result carries no
+// samples, so memory use is O(chunkSize) rather than O(numSteps).
+// summaryOnly logs no samples at all; only run-level data (the summary,
+// events, integrator stats) is returned.
+struct LoggingPolicy {
+    int decimation = 1;              // keep every k-th grid sample (1 = all)
+    std::size_t chunkSize = 4096;    // rows per sink call
+    ResultSink sink;                 // optional streaming consumer
+    bool summaryOnly = false;        // keep no per-sample history
+};
+
+// Opt-in telemetry derived from the logged state while the run executes
+// (see computeDerivedChannels)
+struct DerivedTelemetry {
+    bool enabled = false;
+    Mat3 inertia{};  // body inertia for kinetic energy and angular momentum [kg·m²]
+};
+
 struct SimulationConfig {
-    double dt;
+    double dt;                  // base step: one scheduler tick
     int numSteps;
+    LoggingPolicy logging = {};
+    TaskPeriods schedule = {};  // sensor / controller / actuator periods in ticks
+    std::vector<Event> events = {};  // zero-crossing events checked after every step
+    DerivedTelemetry derived = {};
+    SummaryConfig summary = {};      // scalar metrics accumulated over every grid sample
+};
+
+// One logged channel: a contiguous row-major (size() x Width) block of
+// doubles. Rows sit back-to-back in a single buffer, so the whole channel
+// can be handed to NumPy as an (N, Width) array without copying.
+template <std::size_t Width>
+struct Series {
+    std::vector<double> data;  // size() * Width values
+
+    std::size_t size() const { return data.size() / Width; }
+    bool empty() const { return data.empty(); }
+
+    void reserve(std::size_t rows) { data.reserve(rows * Width); }
+    void resize(std::size_t rows) { data.resize(rows * Width); }
+    void clear() { data.clear(); }
+
+    void push_back(const std::array<double, Width> &row) {
+        data.insert(data.end(), row.begin(), row.end());
+    }
+
+    // Pointer to the first element of row i
+    double *row(std::size_t i) { return data.data() + i * Width; }
+    const double *row(std::size_t i) const { return data.data() + i * Width; }
+
+    // Overwrite existing row i
+    void setRow(std::size_t i, const std::array<double, Width> &values) {
+        std::copy(values.begin(), values.end(), row(i));
+    }
+
+    std::array<double, Width> operator[](std::size_t i) const {
+        std::array<double, Width> out;
+        std::copy(row(i), row(i) + Width, out.begin());
+        return out;
+    }
+
+    std::array<double, Width> back() const { return (*this)[size() - 1]; }
+};
+
+using QuatSeries = Series<4>;
+using Vec3Series = Series<3>;
+
+// Logged channel whose width is only known at run time (e.g. one column per
+// reaction wheel). Same row-major layout as Series; width 0 holds no rows.
+struct DynamicSeries {
+    std::vector<double> data;  // size() * width values
+    std::size_t width = 0;
+
+    std::size_t size() const { return (width > 0) ? data.size() / width : 0; }
+    bool empty() const { return data.empty(); }
+
+    void reserve(std::size_t rows) { data.reserve(rows * width); }
+    void resize(std::size_t rows) { data.resize(rows * width); }
+    void clear() { data.clear(); }
+
+    // Append an uninitialized row and return a pointer to it
+    double *appendRow() {
+        data.resize(data.size() + width);
+        return data.data() + data.size() - width;
+    }
+
+    // Pointer to the first element of row i
+    double *row(std::size_t i) { return data.data() + i * width; }
+    const double *row(std::size_t i) const { return data.data() + i * width; }
+};
+
+// Uniform access to the channel representations in SimulationResult (plain
+// vectors, Series and DynamicSeries), for code that visits forEachChannel
+inline std::size_t channelWidth(const std::vector<double> &) { return 1; }
+
+template <std::size_t Width>
+std::size_t channelWidth(const Series<Width> &) { return Width; }
+
+inline std::size_t channelWidth(const DynamicSeries &series) { return series.width; }
+
+inline const double *channelData(const std::vector<double> &values) { return values.data(); }
+
+template <std::size_t Width>
+const double *channelData(const Series<Width> &series) { return series.data.data(); }
+
+inline const double *channelData(const DynamicSeries &series) { return series.data.data(); }
+
+// Optional channels of a SimulationResult. Consumers that lay out columns
+// before any sample arrives (trajectory files, CSV) need to know them.
+struct ChannelLayout {
+    std::size_t numWheels = 0;  // width of wheelSpeeds
+    bool derived = false;       // derived telemetry channels present
 };
 
 struct SimulationResult {
     std::vector<double> time;            // size N+1
-    std::vector<Quat>   quats;           // size N+1
-    std::vector<Vec3>   omegas;          // size N+1
-    std::vector<Vec3>   commandedTorque; // size N
-    std::vector<Vec3>   appliedTorque;   // size N
+    QuatSeries          quats;           // size N+1
+    Vec3Series          omegas;          // size N+1
+    Vec3Series          commandedTorque; // size N
+    Vec3Series          appliedTorque;   // size N
 
     // reference & error logs (size N+1)
-    std::vector<Quat> qRef;
-    std::vector<Vec3> wRef;
-    std::vector<Vec3> attitudeError;   // 3-vector rotation error in body
-    std::vector<Vec3> rateError;       // ω − ω_ref in body
+    QuatSeries qRef;
+    Vec3Series wRef;
+    Vec3Series attitudeError;   // 3-vector rotation error in body
+    Vec3Series rateError;       // ω − ω_ref in body
+
+    // actuator logs (size N+1)
+    Vec3Series    wheelMomentum;  // rotor momentum h in body [N·m·s]
+    DynamicSeries wheelSpeeds;    // one column per reaction wheel [RPM] (width 0: none)
+
+    // derived telemetry (size N+1, only with ChannelLayout::derived)
+    Vec3Series          eulerAngles;        // roll, pitch, yaw [rad] (extrinsic x-y-z)
+    std::vector<double> attitudeErrorNorm;  // |attitudeError| [rad]
+    std::vector<double> rateErrorNorm;      // |rateError| [rad/s]
+    std::vector<double> kineticEnergy;      // body rotational energy 1/2 ω·Jω [J]
+    Vec3Series          angularMomentum;    // total momentum J ω + h in inertial frame [N·m·s]
+
+    // integrator work (fixed-step methods: accepted = N, rejected = 0)
+    IntegratorStats integratorStats;
+
+    // recorded event crossings in time order; terminated is set when a
+    // terminal event ended the run, whose last sample is then at the event
+    std::vector<EventOccurrence> events;
+    bool terminated = false;
+
+    // scalar metrics of the run (SimulationConfig::summary)
+    SimulationSummary summary;
+
+    // Select the optional channels; call before any row is logged
+    void setLayout(const ChannelLayout &layout) {
+        wheelSpeeds.width = layout.numWheels;
+        derived_ = layout.derived;
+    }
+
+    ChannelLayout layout() const { return ChannelLayout{wheelSpeeds.width, derived_}; }
+
+    // Visit every logged channel as fn(name, channel, perInterval).
+    // perInterval channels (the torques) hold one row per step, N rows;
+    // the others hold one row per grid sample, N+1 rows. Derived channels
+    // are visited only when the layout has them.
+    template <typename Fn>
+    void forEachChannel(Fn &&fn) { forEachChannel_(*this, fn, derived_); }
+
+    template <typename Fn>
+    void forEachChannel(Fn &&fn) const { forEachChannel_(*this, fn, derived_); }
+
+    // Reserve / drop rows in every logged channel
+    void reserve(std::size_t rows) {
+        forEachChannel([rows](const char *, auto &channel, bool) { channel.reserve(rows); });
+    }
+
+    void clearSamples() {
+        forEachChannel([](const char *, auto &channel, bool) { channel.clear(); });
+    }
+
+    // Size the sampled (non-derived) channels to `rows` grid samples and
+    // `intervals` torque rows, so that rows can be written in place
+    void resizeSamples(std::size_t rows, std::size_t intervals) {
+        forEachChannel_(*this, [rows, intervals](const char *, auto &channel, bool perInterval) {
+            channel.resize(perInterval ? intervals : rows);
+        }, false);
+    }
+
+private:
+    template <typename Self, typename Fn>
+    static void forEachChannel_(Self &self, Fn &&fn, bool derived) {
+        fn("time", self.time, false);
+        fn("quats", self.quats, false);
+        fn("omegas", self.omegas, false);
+        fn("commandedTorque", self.commandedTorque, true);
+        fn("appliedTorque", self.appliedTorque, true);
+        fn("qRef", self.qRef, false);
+        fn("wRef", self.wRef, false);
+        fn("attitudeError", self.attitudeError, false);
+        fn("rateError", self.rateError, false);
+        fn("wheelMomentum", self.wheelMomentum, false);
+        fn("wheelSpeeds", self.wheelSpeeds, false);
+        if (derived) {
+            fn("eulerAngles", self.eulerAngles, false);
+            fn("attitudeErrorNorm", self.attitudeErrorNorm, false);
+            fn("rateErrorNorm", self.rateErrorNorm, false);
+            fn("kineticEnergy", self.kineticEnergy, false);
+            fn("angularMomentum", self.angularMomentum, false);
+        }
+    }
+
+    bool derived_ = false;
 };
 
+// Fill the derived telemetry channels of rows [firstRow, time.size()) from
+// the logged state and errors. Works a whole chunk at a time with one
+// plain loop per channel over the contiguous row-major arrays, which the
+// compiler vectorizes (except the trigonometry of the Euler angles).
+void computeDerivedChannels(SimulationResult &log, std::size_t firstRow, const Mat3 &inertia);
+
+// Applies a LoggingPolicy during one run: decides which grid samples are
+// kept, completes the derived channels of each chunk and flushes full
+// chunks to the sink.
+//
+// The buffer's channels are sized for a whole chunk (the whole run without
+// a sink) up front and each sample is written in place at row(), so logging
+// a row costs plain stores; the channels are cut to the rows written before
+// the buffer is handed on.
+class ResultLogger {
+public:
+    //  derived : derived telemetry to compute (null: none); result's layout
+    //            must match
+    ResultLogger(const LoggingPolicy &policy, int numSteps, SimulationResult &result,
+                 const DerivedTelemetry *derived = nullptr)
+        : policy_(policy),
+          numSteps_(numSteps),
+          decimation_(std::max(policy.decimation, 1)),
+          result_(result),
+          derived_((derived && derived->enabled) ? derived : nullptr)
+    {
+        if (policy_.summaryOnly) {
+            // nothing is logged
+        } else if (policy_.sink) {
+            capacity_ = std::max<std::size_t>(policy_.chunkSize, 1);
+        } else {
+            capacity_ = sampleCount(numSteps_, decimation_);
+        }
+        result_.resizeSamples(capacity_, capacity_);
+    }
+
+    // Are samples logged at all?
+    bool logging() const { return !policy_.summaryOnly; }
+
+    // Is grid sample k logged?
+    bool due(int k) const {
+        return logging() && (decimation_ == 1 || k % decimation_ == 0 || k == numSteps_);
+    }
+
+    // Number of grid samples a run of numSteps logs at this decimation
+    static std::size_t sampleCount(int numSteps, int decimation) {
+        decimation = std::max(decimation, 1);
+        std::size_t rows = static_cast<std::size_t>(numSteps / decimation) + 1;
+        if (numSteps % decimation != 0) {
+            rows += 1;  // final sample
+        }
+        return rows;
+    }
+
+    // Buffer the current row is written to, and its index there
+    SimulationResult &buffer() { return result_; }
+    std::size_t row() const { return rows_; }
+
+    // Call after a complete row has been written; withTorques: the row's
+    // torques were written too (every sample but the last)
+    void rowDone(bool withTorques) {
+        ++rows_;
+        intervals_ += withTorques ? 1 : 0;
+        if (rows_ == capacity_ && policy_.sink) {
+            flush();
+            result_.resizeSamples(capacity_, capacity_);
+        }
+    }
+
+    // Call once after the final sample
+    void finish() {
+        result_.resizeSamples(rows_, intervals_);
+        if (policy_.sink && rows_ > 0) {
+            flush();
+        } else {
+            completeDerived();
+        }
+    }
+
+private:
+    void completeDerived() {
+        if (derived_) {
+            computeDerivedChannels(result_, result_.attitudeErrorNorm.size(), derived_->inertia);
+        }
+    }
+
+    // Hand rows_ complete rows to the sink and start an empty chunk
+    void flush() {
+        result_.resizeSamples(rows_, intervals_);
+        completeDerived();
+        policy_.sink(result_);
+        result_.clearSamples();
+        rows_ = 0;
+        intervals_ = 0;
+    }
+
+    const LoggingPolicy &policy_;
+    int numSteps_;
+    int decimation_;
+    SimulationResult &result_;
+    const DerivedTelemetry *derived_;
+    std::size_t capacity_ = 0;   // rows the buffer's channels are sized for
+    std::size_t rows_ = 0;       // rows written to the buffer so far
+    std::size_t intervals_ = 0;  // of which with torques
+};
+
+// Closed-loop propagation shared by AttitudeSimulation and
+// StaticAttitudeSimulation.
+//
+// The component types are template parameters. Instantiated with the
+// abstract interfaces (and Integrator) it dispatches at run time;
+// instantiated with concrete (final) classes and a StaticIntegrator every
+// call in the step loop is resolved statically and can be inlined end to
+// end. Per-run component state is local to the call.
+//
+// Components run on the integer tick grid t_k = k*dt at the periods given
+// by cfg.schedule (see MultiRateScheduler) and are skipped on the ticks they
+// are not due, their last output being held. Logging runs on the same grid
+// at cfg.logging.decimation.
+template <typename Dyn, typename Integ, typename Ctrl, typename Sens, typename Est, typename Act, typename Ref>
+SimulationResult simulateAttitude(
+    const Dyn &dynamics,
+    const Integ &integrator,
+    const Ctrl &controller,
+    const Sens &sensor,
+    const Est &estimator,
+    const Act &actuator,
+    const Ref &referenceProfile,
+    const SimulationConfig &cfg,
+    const AttitudeState &x0
+) {
+    SimulationResult result;
+    const int nSteps = cfg.numSteps;
+    const double t0 = 0;  // always start from t = 0
+    const double dt = cfg.dt;
+
+    result.setLayout(ChannelLayout{actuator.numWheels(), cfg.derived.enabled});
+    ResultLogger logger(cfg.logging, nSteps, result, &cfg.derived);
+
+    ControllerState controllerState;
+    SensorState sensorState = sensor.initialState();
+    EstimatorState estimatorState = estimator.initialState();
+    ActuatorState actuatorState = actuator.initialState();
+
+    // The summary sees every grid sample, logged or not
+    const bool summarize = cfg.summary.enabled;
+    SummaryAccumulator summary(cfg.summary);
+    std::vector<double> summaryWheelSpeeds(summarize ? actuator.numWheels() : 0);
+
+    // Grid sample at time tk: feeds the summary and, when `logged`, logs
+    // time, state, reference and errors plus the torques held over
+    // [t_k, t_k+1) when given (every sample but the last)
+    auto sample = [&](bool logged, double tk, const AttitudeState &xk,
+                      const Vec3 *commanded, const Vec3 *applied) {
+        if (!logged && !summarize) {
+            return;
+        }
+
+        // reference at this grid time
+        ReferenceState ref = referenceProfile.computeReferenceState(tk, xk);
+
+        // attitude error: q_err = q_ref^{-1} ⊗ q
+        Quat qRefConj = quatConjugate(ref.qRef);
+        Quat qErr     = quatMultiply(qRefConj, xk.q);
+
+        double qw = qErr[0];
+        Vec3 qv   = { qErr[1], qErr[2], qErr[3] };
+
+        double sign_qw = (qw >= 0.0) ? 1.0 : -1.0;
+
+        Vec3 eAtt = {
+            2.0 * sign_qw * qv[0],
+            2.0 * sign_qw * qv[1],
+            2.0 * sign_qw * qv[2]
+        };
+
+        // rate error: ω − ω_ref
+        Vec3 eW = {
+            xk.w[0] - ref.wRef[0],
+            xk.w[1] - ref.wRef[1],
+            xk.w[2] - ref.wRef[2]
+        };
+
+        if (summarize) {
+            actuator.wheelSpeedsAt(tk, actuatorState, summaryWheelSpeeds.data());
+            summary.addSample(tk, eAtt, eW, summaryWheelSpeeds.data(), summaryWheelSpeeds.size(),
+                              commanded, applied);
+        }
+        if (!logged) {
+            return;
+        }
+
+        SimulationResult &log = logger.buffer();
+        const std::size_t i = logger.row();
+
+        // state and reference
+        log.time[i] = tk;
+        log.quats.setRow(i, xk.q);
+        log.omegas.setRow(i, xk.w);
+        log.qRef.setRow(i, ref.qRef);
+        log.wRef.setRow(i, ref.wRef);
+
+        log.attitudeError.setRow(i, eAtt);
+        log.rateError.setRow(i, eW);
+
+        // rotor momentum and the wheel speeds behind it
+        log.wheelMomentum.setRow(i, xk.h);
+        if (log.wheelSpeeds.width > 0) {
+            actuator.wheelSpeedsAt(tk, actuatorState, log.wheelSpeeds.row(i));
+        }
+
+        // torques
+        const bool withTorques = commanded && applied;
+        if (withTorques) {
+            log.commandedTorque.setRow(i, *commanded);
+            log.appliedTorque.setRow(i, *applied);
+        }
+
+        logger.rowDone(withTorques);
+    };
+
+    // Outputs held between the ticks their task runs on
+    AttitudeState estimatedState = x0;
+    Vec3 commanded{0.0, 0.0, 0.0};
+    Vec3 applied{0.0, 0.0, 0.0};
+
+    const MultiRateScheduler scheduler(cfg.schedule);
+    auto gridTime = [&](int k) { return t0 + static_cast<double>(k) * dt; };
+
+    // sensor -> estimator -> reference -> controller -> actuator, each only
+    // if due on tick k; x is the true state at t = t_k
+    auto runDueTasks = [&](int k, double t, const AttitudeState &x) {
+        // 1. sensor measurement (attitude and rate), filtered into the
+        //    estimated state the controller acts on
+        if (scheduler.sensorDue(k)) {
+            AttitudeState measured = sensor.measure(t, x, sensorState);
+            estimatedState = estimator.estimate(t, measured, estimatorState);
+        }
+
+        // 2. reference state (desired attitude / rate at time t) and
+        //    commanded torque in body frame
+        if (scheduler.controllerDue(k)) {
+            ReferenceState ref = referenceProfile.computeReferenceState(t, estimatedState);
+            commanded = controller.computeCommandTorque(t, estimatedState, ref, controllerState);
+        }
+
+        // 3. actuator: apply command, get actual applied torque
+        if (scheduler.actuatorDue(k)) {
+            actuatorState.holdUntil = gridTime(std::min(scheduler.nextActuatorTick(k), nSteps));
+            applied = actuator.applyCommand(t, x, commanded, actuatorState);
+        }
+    };
+
+    // Event functions at time t: g[i] for every configured event
+    const std::vector<Event> &events = cfg.events;
+    std::vector<double> gPrev(events.size()), gNew(events.size());
+    std::vector<double> eventWheelSpeeds(actuator.numWheels());
+    auto evalEvent = [&](std::size_t i, double t, const AttitudeState &x) {
+        const ReferenceState ref = referenceProfile.computeReferenceState(t, x);
+        actuator.wheelSpeedsAt(t, actuatorState, eventWheelSpeeds.data());
+        return events[i].g(EventSample{t, x, ref, eventWheelSpeeds.data(), eventWheelSpeeds.size()});
+    };
+
+    // Check every event over the step [ta, tb], locating crossings on the
+    // step's interpolant. Records crossings up to the first terminal one;
+    // returns true, with its time and state, if a terminal event fired.
+    std::vector<EventOccurrence> crossings;
+    auto checkEvents = [&](double tb, const AttitudeState &xb, double ta, const auto &interp,
+                           double &tStop, AttitudeState &xStop) {
+        crossings.clear();
+        tStop = tb;
+        bool stop = false;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            gNew[i] = evalEvent(i, tb, xb);
+            if (!eventCrossed(events[i].direction, gPrev[i], gNew[i])) {
+                continue;
+            }
+            const double tc = locateEventTime(
+                [&](double t) { return evalEvent(i, t, interp(t)); }, ta, gPrev[i], tb, gNew[i]);
+            if (events[i].record) {
+                crossings.push_back(EventOccurrence{events[i].name, tc});
+            }
+            if (events[i].terminal && (!stop || tc < tStop)) {
+                stop = true;
+                tStop = tc;
+            }
+        }
+        std::swap(gPrev, gNew);
+
+        std::stable_sort(crossings.begin(), crossings.end(),
+            [](const EventOccurrence &a, const EventOccurrence &b) { return a.t < b.t; });
+        for (const EventOccurrence &c : crossings) {
+            if (!stop || c.t <= tStop) {
+                result.events.push_back(c);
+            }
+        }
+        if (stop) {
+            xStop = (tStop < tb) ? interp(tStop) : xb;
+            result.terminated = true;
+        }
+        return stop;
+    };
+
+    AttitudeState x = x0;
+
+    // The actuator's rotors start with their own momentum (e.g. wheel speeds)
+    const Vec3 h0 = actuator.rotorMomentum(actuatorState);
+    for (int i = 0; i < 3; ++i) {
+        x.h[i] += h0[i];
+    }
+
+    // End of the run: the final grid time, or a terminal event
+    double tEnd = gridTime(nSteps);
+
+    if (!integrator.isAdaptive()) {
+        for (int k = 0; k < nSteps; ++k) {
+            const double t = gridTime(k);
+            runDueTasks(k, t, x);
+            if (k == 0) {
+                for (std::size_t i = 0; i < events.size(); ++i) {
+                    gPrev[i] = evalEvent(i, t, x);
+                }
+            }
+
+            sample(logger.due(k), t, x, &commanded, &applied);
+
+            // propagate with the applied torque held over the step
+            const AttitudeState xNew = integrator.step(dynamics, t, x, dt, applied);
+            ++result.integratorStats.acceptedSteps;
+
+            // Events are located on the cubic Hermite interpolant of the step
+            if (!events.empty()) {
+                const double tNew = gridTime(k + 1);
+                const HermiteOutput interp{
+                    t, tNew - t, x, xNew,
+                    dynamics.computeDerivative(t, x, applied),
+                    dynamics.computeDerivative(tNew, xNew, applied)
+                };
+                if (checkEvents(tNew, xNew, t, interp, tEnd, x)) {
+                    break;
+                }
+            }
+            x = xNew;
+        }
+    } else {
+        // Adaptive: the applied torque only changes on actuator ticks, so
+        // each interval between them is integrated with error-controlled
+        // steps that end exactly on the next one. Sensor and controller
+        // ticks inside an interval, and the logging grid, are served from
+        // the dense output and do not constrain the step size.
+        int k = 0;       // tick at the start of the hold interval
+        double h = dt;   // step-size guess, carried across hold intervals
+
+        bool stopped = false;
+        AttitudeState xStop;
+
+        while (k < nSteps && !stopped) {
+            const double t = gridTime(k);
+            runDueTasks(k, t, x);
+            if (k == 0) {
+                for (std::size_t i = 0; i < events.size(); ++i) {
+                    gPrev[i] = evalEvent(i, t, x);
+                }
+            }
+            sample(logger.due(k), t, x, &commanded, &applied);
+
+            const int kHold = std::min(scheduler.nextActuatorTick(k), nSteps);
+            int kNext = k + 1;  // next tick to serve
+
+            // Run the tasks and log every tick in [ta, tb) of each accepted
+            // step; the tick on kHold starts the next interval. A terminal
+            // event cuts the step short and ends the propagation.
+            auto serveTicks = [&](double ta, const AttitudeState &xa, double tb,
+                                  const AttitudeState &xb, const DenseOutput &dense) {
+                if (!events.empty() && checkEvents(tb, xb, ta, dense, tEnd, xStop)) {
+                    stopped = true;
+                    tb = tEnd;
+                }
+                while (kNext < kHold && gridTime(kNext) < tb) {
+                    const double tk = gridTime(kNext);
+                    const AttitudeState xk = (tk <= ta) ? xa : dense(tk);
+                    runDueTasks(kNext, tk, xk);
+                    sample(logger.due(kNext), tk, xk, &commanded, &applied);
+                    ++kNext;
+                }
+                return !stopped;
+            };
+
+            x = integrator.propagateAdaptive(
+                dynamics, t, x, gridTime(kHold), applied, h, result.integratorStats, serveTicks);
+            k = kHold;
+        }
+        if (stopped) {
+            x = xStop;
+        }
+    }
+    sample(logger.logging(), tEnd, x, nullptr, nullptr);
+    logger.finish();
+    if (summarize) {
+        result.summary = summary.summary();
+    }
+
+    return result;
+}
+
+// Run-time composed simulation: components are owned through their abstract
+// interfaces and may be any implementation.
 class AttitudeSimulation {
 public:
     AttitudeSimulation(
@@ -39,9 +653,13 @@ public:
         std::unique_ptr<Controller> controller,
         std::unique_ptr<Sensor> sensor,
         std::unique_ptr<Actuator> actuator,
-        std::unique_ptr<ReferenceProfile> referenceProfile
+        std::unique_ptr<ReferenceProfile> referenceProfile,
+        std::unique_ptr<Estimator> estimator = nullptr  // null: PassThroughEstimator
     );
 
+    // Run one simulation from x0. All per-run state (controller
+    // sample-and-hold, wheel speeds, logs) is local to the call, so run()
+    // may be called repeatedly and concurrently on the same object.
     SimulationResult run(
         const SimulationConfig &cfg,
         const AttitudeState &x0
@@ -54,6 +672,52 @@ private:
     std::unique_ptr<Sensor> sensor_;
     std::unique_ptr<Actuator> actuator_;
     std::unique_ptr<ReferenceProfile> referenceProfile_;
+    std::unique_ptr<Estimator> estimator_;
+};
+
+// Compile-time composed simulation: components are held by value with their
+// concrete types, so the step loop has no std::function, no virtual calls and
+// no per-step integrator dispatch. Use with final component classes (e.g.
+// RigidBodyDynamics, PDController) and a StaticIntegrator.
+template <typename Dyn, typename Integ, typename Ctrl, typename Sens, typename Est, typename Act, typename Ref>
+class StaticAttitudeSimulation {
+public:
+    StaticAttitudeSimulation(
+        Dyn dynamics,
+        Integ integrator,
+        Ctrl controller,
+        Sens sensor,
+        Est estimator,
+        Act actuator,
+        Ref referenceProfile
+    )
+        : dynamics_(std::move(dynamics)),
+          integrator_(std::move(integrator)),
+          controller_(std::move(controller)),
+          sensor_(std::move(sensor)),
+          estimator_(std::move(estimator)),
+          actuator_(std::move(actuator)),
+          referenceProfile_(std::move(referenceProfile))
+    {}
+
+    // Same contract as AttitudeSimulation::run
+    SimulationResult run(
+        const SimulationConfig &cfg,
+        const AttitudeState &x0
+    ) const {
+        return simulateAttitude(
+            dynamics_, integrator_, controller_, sensor_, estimator_, actuator_,
+            referenceProfile_, cfg, x0);
+    }
+
+private:
+    Dyn dynamics_;
+    Integ integrator_;
+    Ctrl controller_;
+    Sens sensor_;
+    Est estimator_;
+    Act actuator_;
+    Ref referenceProfile_;
 };
 
 } // namespace starSense
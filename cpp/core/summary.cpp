@@ -0,0 +1,83 @@
+#include "summary.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace starSense {
+
+SummaryAccumulator::SummaryAccumulator(const SummaryConfig &config)
+    : config_(config)
+{}
+
+void SummaryAccumulator::addSample(
+    double t,
+    const Vec3 &eAtt,
+    const Vec3 &eW,
+    const double *wheelSpeeds,
+    std::size_t numWheels,
+    const Vec3 *commanded,
+    const Vec3 *applied
+) {
+    // Torque metrics over the interval held since the previous sample (the
+    // last one may be cut short by a terminal event)
+    if (holding_) {
+        const double span = t - tPrev_;
+        summary_.controlImpulse += appliedNorm_ * span;
+        if (saturated_) {
+            summary_.saturationTime += span;
+        }
+    }
+    holding_ = (commanded && applied);
+    if (holding_) {
+        const Vec3 &c = *commanded;
+        const Vec3 &a = *applied;
+        appliedNorm_ = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+        saturated_ = std::abs(c[0] - a[0]) > config_.saturationTolerance
+                  || std::abs(c[1] - a[1]) > config_.saturationTolerance
+                  || std::abs(c[2] - a[2]) > config_.saturationTolerance;
+    }
+    tPrev_ = t;
+
+    const double attError = std::sqrt(eAtt[0] * eAtt[0] + eAtt[1] * eAtt[1] + eAtt[2] * eAtt[2]);
+    const double rateError = std::sqrt(eW[0] * eW[0] + eW[1] * eW[1] + eW[2] * eW[2]);
+
+    if (summary_.samples == 0 || attError > summary_.peakAttitudeError) {
+        summary_.peakAttitudeError = attError;
+        summary_.peakAttitudeErrorTime = t;
+    }
+    summary_.peakRateError = std::max(summary_.peakRateError, rateError);
+
+    if (t >= config_.rmsStartTime) {
+        sumSquares_ += attError * attError;
+        ++rmsSamples_;
+    }
+
+    const bool inside = attError <= config_.settlingAttitudeError
+        && (config_.settlingRateError <= 0.0 || rateError <= config_.settlingRateError);
+    if (inside && !inBand_) {
+        bandEntry_ = t;
+    }
+    inBand_ = inside;
+
+    for (std::size_t i = 0; i < numWheels; ++i) {
+        summary_.maxWheelSpeed = std::max(summary_.maxWheelSpeed, std::abs(wheelSpeeds[i]));
+    }
+
+    summary_.finalAttitudeError = attError;
+    summary_.finalRateError = rateError;
+    summary_.endTime = t;
+    ++summary_.samples;
+}
+
+SimulationSummary SummaryAccumulator::summary() const {
+    SimulationSummary out = summary_;
+    if (config_.settlingAttitudeError > 0.0 && inBand_) {
+        out.settlingTime = bandEntry_;
+    }
+    if (rmsSamples_ > 0) {
+        out.rmsAttitudeError = std::sqrt(sumSquares_ / static_cast<double>(rmsSamples_));
+    }
+    return out;
+}
+
+} // namespace starSense
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "types.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Run summary
+//
+// Scalar metrics of one run, accumulated sample by sample on the base grid
+// while the run executes, in O(1) memory. They do not depend on the logging
+// decimation, and a run can keep the summary alone (LoggingPolicy::
+// summaryOnly) without storing any per-sample history.
+// ----------------------------------------------------------
+
+// Which metrics to accumulate and their thresholds
+struct SummaryConfig {
+    bool enabled = false;
+    double settlingAttitudeError = 0.01;  // |e_att| band for the settling time [rad] (<= 0: none)
+    double settlingRateError = 0.0;       // |e_w| band as well (<= 0: attitude only) [rad/s]
+    double rmsStartTime = 0.0;            // RMS pointing error over samples with t >= this [s]
+    double saturationTolerance = 1e-9;    // |commanded - applied| that counts as saturated [N·m]
+};
+
+struct SimulationSummary {
+    std::size_t samples = 0;  // grid samples accumulated
+    double endTime = 0.0;     // time of the last sample [s]
+
+    // Time after which the errors stay inside the settling band: the first
+    // sample after the last one outside it (NaN: not settled by the end, or
+    // no band configured)
+    double settlingTime = std::numeric_limits<double>::quiet_NaN();
+
+    double peakAttitudeError = 0.0;      // max |e_att| [rad]
+    double peakAttitudeErrorTime = 0.0;  // time of that peak [s]
+    double peakRateError = 0.0;          // max |e_w| [rad/s]
+    double rmsAttitudeError = 0.0;       // RMS |e_att| from rmsStartTime on [rad]
+    double finalAttitudeError = 0.0;     // |e_att| at the last sample [rad]
+    double finalRateError = 0.0;         // |e_w| at the last sample [rad/s]
+
+    double controlImpulse = 0.0;  // integral of |applied torque| dt [N·m·s]
+    double saturationTime = 0.0;  // time the applied torque differed from the command [s]
+    double maxWheelSpeed = 0.0;   // max |wheel speed| over wheels and samples [RPM]
+};
+
+// Accumulates a SimulationSummary from the samples of one run, in time order
+class SummaryAccumulator {
+public:
+    explicit SummaryAccumulator(const SummaryConfig &config);
+
+    //  t                 : sample time
+    //  eAtt, eW          : attitude and rate errors at t
+    //  wheelSpeeds       : numWheels speeds at t [RPM]
+    //  commanded, applied: torques held from t to the next sample (null on
+    //                      the last sample)
+    void addSample(double t, const Vec3 &eAtt, const Vec3 &eW,
+                   const double *wheelSpeeds, std::size_t numWheels,
+                   const Vec3 *commanded, const Vec3 *applied);
+
+    SimulationSummary summary() const;
+
+private:
+    SummaryConfig config_;
+    SimulationSummary summary_;
+
+    // Torques held since the previous sample
+    bool holding_ = false;
+    double tPrev_ = 0.0;
+    double appliedNorm_ = 0.0;
+    bool saturated_ = false;
+
+    // Settling: start of the current run of samples inside the band
+    bool inBand_ = false;
+    double bandEntry_ = 0.0;
+
+    double sumSquares_ = 0.0;
+    std::size_t rmsSamples_ = 0;
+};
+
+} // namespace starSense
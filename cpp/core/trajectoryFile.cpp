@@ -0,0 +1,335 @@
+#include "trajectoryFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace starSense {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'S', 'T', 'R', 'A', 'J', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint64_t kAlign = 64;
+constexpr std::size_t kMaxNameLength = 31;
+
+// On-disk header (64 bytes)
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numChannels;
+    std::uint64_t metadataOffset;
+    std::uint64_t metadataSize;
+    std::uint64_t chunkIndexOffset;  // 0 until the writer is closed
+    std::uint64_t numChunks;
+    std::uint64_t reserved[2];
+};
+
+// On-disk channel table entry (64 bytes)
+struct ChannelEntry {
+    char name[32];
+    std::uint32_t width;
+    std::uint32_t dtype;
+    std::uint64_t offset;
+    std::uint64_t capacity;
+    std::uint64_t rows;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+static_assert(sizeof(ChannelEntry) == 64, "ChannelEntry must be 64 bytes");
+static_assert(sizeof(TrajectoryChunk) == 16, "TrajectoryChunk must be 16 bytes");
+
+std::uint64_t alignUp(std::uint64_t n) {
+    return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+std::string systemError(const std::string &what, const std::string &path) {
+    return what + " '" + path + "': " + std::strerror(errno);
+}
+
+} // namespace
+
+// ----------------------------------------------------------
+// TrajectoryWriter
+// ----------------------------------------------------------
+
+TrajectoryWriter::TrajectoryWriter(
+    const std::string &path,
+    std::size_t sampleRows,
+    const std::string &metadata,
+    TrajectoryDtype dtype,
+    const ChannelLayout &layout
+)
+    : path_(path),
+      metadata_(metadata)
+{
+    // Channel layout comes from SimulationResult itself
+    SimulationResult columns;
+    columns.setLayout(layout);
+    columns.forEachChannel([&](const char *name, const auto &channel, bool perInterval) {
+        Column col;
+        col.name = name;
+        col.width = channelWidth(channel);
+        col.dtype = (col.name == "time") ? TrajectoryDtype::Float64 : dtype;
+        col.offset = 0;
+        col.capacity = perInterval ? (sampleRows > 0 ? sampleRows - 1 : 0) : sampleRows;
+        col.rows = 0;
+        if (col.name.size() > kMaxNameLength) {
+            throw std::invalid_argument("TrajectoryWriter: channel name too long: " + col.name);
+        }
+        columns_.push_back(col);
+    });
+
+    // Data regions follow the header, channel table and metadata
+    std::uint64_t offset = alignUp(
+        sizeof(FileHeader) + columns_.size() * sizeof(ChannelEntry) + metadata_.size());
+    for (auto &col : columns_) {
+        col.offset = offset;
+        offset = alignUp(offset + col.capacity * col.width * static_cast<std::uint64_t>(col.dtype));
+    }
+    dataEnd_ = offset;
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error(systemError("TrajectoryWriter: cannot open", path_));
+    }
+
+    // Size the file up front (sparse on most filesystems)
+    if (::ftruncate(fd_, static_cast<off_t>(dataEnd_)) != 0) {
+        const std::string msg = systemError("TrajectoryWriter: cannot size", path_);
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(msg);
+    }
+
+    writeHeader_(false);
+    writeAt_(sizeof(FileHeader) + columns_.size() * sizeof(ChannelEntry),
+             metadata_.data(), metadata_.size());
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    try {
+        close();
+    } catch (...) {
+        // destructors must not throw; call close() explicitly to see errors
+    }
+}
+
+void TrajectoryWriter::write(const SimulationResult &chunk) {
+    if (fd_ < 0) {
+        throw std::runtime_error("TrajectoryWriter: write after close");
+    }
+
+    chunks_.push_back(TrajectoryChunk{columns_.front().rows, chunk.time.size()});
+
+    std::size_t j = 0;
+    chunk.forEachChannel([&](const char *, const auto &channel, bool) {
+        Column &col = columns_[j++];
+        const std::size_t rows = channel.size();
+        if (col.rows + rows > col.capacity) {
+            throw std::runtime_error(
+                "TrajectoryWriter: more rows than reserved for channel " + col.name);
+        }
+
+        const std::size_t count = rows * col.width;
+        const std::uint64_t elemSize = static_cast<std::uint64_t>(col.dtype);
+        const std::uint64_t at = col.offset + col.rows * col.width * elemSize;
+        const double *src = channelData(channel);
+
+        if (col.dtype == TrajectoryDtype::Float64) {
+            writeAt_(at, src, count * sizeof(double));
+        } else {
+            scratch_.resize(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                scratch_[i] = static_cast<float>(src[i]);
+            }
+            writeAt_(at, scratch_.data(), count * sizeof(float));
+        }
+        col.rows += rows;
+    });
+}
+
+void TrajectoryWriter::close() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    writeAt_(dataEnd_, chunks_.data(), chunks_.size() * sizeof(TrajectoryChunk));
+    writeHeader_(true);
+
+    const int fd = fd_;
+    fd_ = -1;
+    if (::close(fd) != 0) {
+        throw std::runtime_error(systemError("TrajectoryWriter: cannot close", path_));
+    }
+}
+
+ResultSink TrajectoryWriter::sink() {
+    return [this](const SimulationResult &chunk) { write(chunk); };
+}
+
+void TrajectoryWriter::writeAt_(std::uint64_t offset, const void *data, std::size_t bytes) {
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0) {
+        const ssize_t n = ::pwrite(fd_, p, bytes, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(systemError("TrajectoryWriter: write failed for", path_));
+        }
+        p += n;
+        offset += static_cast<std::uint64_t>(n);
+        bytes -= static_cast<std::size_t>(n);
+    }
+}
+
+void TrajectoryWriter::writeHeader_(bool finalized) {
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.numChannels = static_cast<std::uint32_t>(columns_.size());
+    header.metadataOffset = sizeof(FileHeader) + columns_.size() * sizeof(ChannelEntry);
+    header.metadataSize = metadata_.size();
+    header.chunkIndexOffset = finalized ? dataEnd_ : 0;
+    header.numChunks = chunks_.size();
+
+    std::vector<ChannelEntry> entries(columns_.size());
+    for (std::size_t j = 0; j < columns_.size(); ++j) {
+        const Column &col = columns_[j];
+        ChannelEntry &e = entries[j];
+        std::memset(&e, 0, sizeof(e));
+        std::memcpy(e.name, col.name.c_str(), col.name.size());
+        e.width = static_cast<std::uint32_t>(col.width);
+        e.dtype = static_cast<std::uint32_t>(col.dtype);
+        e.offset = col.offset;
+        e.capacity = col.capacity;
+        e.rows = col.rows;
+    }
+
+    writeAt_(0, &header, sizeof(header));
+    writeAt_(sizeof(header), entries.data(), entries.size() * sizeof(ChannelEntry));
+}
+
+// ----------------------------------------------------------
+// TrajectoryFile
+// ----------------------------------------------------------
+
+TrajectoryFile::TrajectoryFile(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(systemError("TrajectoryFile: cannot open", path));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        const std::string msg = systemError("TrajectoryFile: cannot stat", path);
+        ::close(fd);
+        throw std::runtime_error(msg);
+    }
+    mapSize_ = static_cast<std::size_t>(st.st_size);
+    if (mapSize_ < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("TrajectoryFile: '" + path + "' is too small to be a trajectory file");
+    }
+
+    map_ = ::mmap(nullptr, mapSize_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file open
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        throw std::runtime_error(systemError("TrajectoryFile: cannot map", path));
+    }
+
+    // From here on, unmap on any validation failure
+    try {
+        const char *base = static_cast<const char *>(map_);
+        FileHeader header;
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("TrajectoryFile: '" + path + "' is not a trajectory file");
+        }
+        if (header.version != kVersion) {
+            throw std::runtime_error(
+                "TrajectoryFile: unsupported version " + std::to_string(header.version));
+        }
+
+        // count elements of elementSize bytes each at offset must lie in the
+        // file; compared by division, as the header fields are untrusted and
+        // their product can wrap around
+        auto checkRange = [&](std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize,
+                              const char *what) {
+            if (offset > mapSize_ || (elementSize != 0 && count > (mapSize_ - offset) / elementSize)) {
+                throw std::runtime_error(
+                    std::string("TrajectoryFile: truncated file (") + what + ")");
+            }
+        };
+
+        checkRange(sizeof(FileHeader), header.numChannels, sizeof(ChannelEntry), "channel table");
+        checkRange(header.metadataOffset, header.metadataSize, 1, "metadata");
+        metadata_.assign(base + header.metadataOffset, header.metadataSize);
+
+        for (std::uint32_t j = 0; j < header.numChannels; ++j) {
+            ChannelEntry e;
+            std::memcpy(&e, base + sizeof(FileHeader) + j * sizeof(ChannelEntry), sizeof(e));
+            if (e.dtype != static_cast<std::uint32_t>(TrajectoryDtype::Float32) &&
+                e.dtype != static_cast<std::uint32_t>(TrajectoryDtype::Float64)) {
+                throw std::runtime_error("TrajectoryFile: bad dtype in channel table");
+            }
+            checkRange(e.offset, e.rows, std::uint64_t{e.width} * e.dtype, "channel data");
+
+            e.name[sizeof(e.name) - 1] = '\0';
+            channels_.push_back(TrajectoryChannel{
+                e.name,
+                e.width,
+                static_cast<TrajectoryDtype>(e.dtype),
+                static_cast<std::size_t>(e.rows),
+                base + e.offset
+            });
+        }
+
+        if (header.chunkIndexOffset != 0) {
+            checkRange(header.chunkIndexOffset, header.numChunks, sizeof(TrajectoryChunk), "chunk index");
+            chunks_.resize(header.numChunks);
+            std::memcpy(chunks_.data(), base + header.chunkIndexOffset,
+                        header.numChunks * sizeof(TrajectoryChunk));
+        }
+    } catch (...) {
+        ::munmap(map_, mapSize_);
+        map_ = nullptr;
+        throw;
+    }
+}
+
+TrajectoryFile::~TrajectoryFile() {
+    if (map_) {
+        ::munmap(map_, mapSize_);
+    }
+}
+
+TrajectoryFile::TrajectoryFile(TrajectoryFile &&other) noexcept
+    : map_(other.map_),
+      mapSize_(other.mapSize_),
+      metadata_(std::move(other.metadata_)),
+      channels_(std::move(other.channels_)),
+      chunks_(std::move(other.chunks_))
+{
+    other.map_ = nullptr;
+    other.mapSize_ = 0;
+}
+
+const TrajectoryChannel &TrajectoryFile::channel(const std::string &name) const {
+    for (const auto &c : channels_) {
+        if (c.name == name) {
+            return c;
+        }
+    }
+    throw std::out_of_range("TrajectoryFile: no channel named '" + name + "'");
+}
+
+} // namespace starSense
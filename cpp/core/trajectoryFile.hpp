@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Columnar binary trajectory file (.sstraj)
+//
+// Layout (little-endian):
+//   FileHeader
+//   ChannelEntry[numChannels]
+//   metadata blob (UTF-8, e.g. the run parameters as JSON)
+//   one contiguous data region per channel, 64-byte aligned, sized for the
+//     full run up front so each channel is a single (rows x width) array
+//   TrajectoryChunk[numChunks]   (chunk index, written when the writer is closed)
+//
+// Because every channel is contiguous on disk, a reader can memory-map the
+// file and view a whole channel as one array without copying or parsing.
+// ----------------------------------------------------------
+
+enum class TrajectoryDtype : std::uint32_t {
+    Float32 = 4,
+    Float64 = 8
+};
+
+// One channel as seen by a reader: rows x width values of dtype at data
+struct TrajectoryChannel {
+    std::string name;
+    std::size_t width;
+    TrajectoryDtype dtype;
+    std::size_t rows;
+    const void *data;
+};
+
+// One writer chunk: rows [firstRow, firstRow + rows) of the sample channels
+struct TrajectoryChunk {
+    std::uint64_t firstRow;
+    std::uint64_t rows;
+};
+
+// Streams SimulationResult chunks into a trajectory file while a run is in
+// progress. Use sink() as the LoggingPolicy sink; close() finalizes the
+// header and chunk index (the destructor closes too, ignoring errors).
+class TrajectoryWriter {
+public:
+    //  path        : output file (truncated)
+    //  sampleRows  : grid samples the run will log (ResultLogger::sampleCount)
+    //  metadata    : free-form text stored in the header
+    //  dtype       : storage type for every channel except time (always float64)
+    //  layout      : optional channels the run logs (wheel count, derived telemetry)
+    TrajectoryWriter(
+        const std::string &path,
+        std::size_t sampleRows,
+        const std::string &metadata,
+        TrajectoryDtype dtype = TrajectoryDtype::Float64,
+        const ChannelLayout &layout = {}
+    );
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter &) = delete;
+    TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+
+    // Append one chunk of logged samples
+    void write(const SimulationResult &chunk);
+
+    // Write the chunk index and final row counts, then close the file
+    void close();
+
+    // Sink forwarding to write(); the writer must outlive the run
+    ResultSink sink();
+
+private:
+    struct Column {
+        std::string name;
+        std::size_t width;
+        TrajectoryDtype dtype;
+        std::uint64_t offset;    // start of the data region
+        std::uint64_t capacity;  // rows reserved
+        std::uint64_t rows;      // rows written
+    };
+
+    void writeAt_(std::uint64_t offset, const void *data, std::size_t bytes);
+    void writeHeader_(bool finalized);
+
+    std::string path_;
+    int fd_ = -1;
+    std::string metadata_;
+    std::vector<Column> columns_;
+    std::vector<TrajectoryChunk> chunks_;
+    std::uint64_t dataEnd_ = 0;
+    std::vector<float> scratch_;
+};
+
+// Read-only, memory-mapped view of a trajectory file. Opening only maps the
+// file and parses the header, so cost does not depend on file size. Channel
+// data pointers stay valid for the lifetime of the object.
+class TrajectoryFile {
+public:
+    explicit TrajectoryFile(const std::string &path);
+    ~TrajectoryFile();
+
+    TrajectoryFile(const TrajectoryFile &) = delete;
+    TrajectoryFile &operator=(const TrajectoryFile &) = delete;
+    TrajectoryFile(TrajectoryFile &&other) noexcept;
+    TrajectoryFile &operator=(TrajectoryFile &&other) = delete;
+
+    const std::string &metadata() const { return metadata_; }
+    const std::vector<TrajectoryChannel> &channels() const { return channels_; }
+    const std::vector<TrajectoryChunk> &chunks() const { return chunks_; }
+
+    // Channel by name (throws std::out_of_range if absent)
+    const TrajectoryChannel &channel(const std::string &name) const;
+
+private:
+    void *map_ = nullptr;
+    std::size_t mapSize_ = 0;
+    std::string metadata_;
+    std::vector<TrajectoryChannel> channels_;
+    std::vector<TrajectoryChunk> chunks_;
+};
+
+} // namespace starSense
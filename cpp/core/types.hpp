@@ -12,6 +12,7 @@ using Mat3x6 = std::array<std::array<double, 6>, 3>;
 struct AttitudeState {
     Quat q;   // unit quaternion, body wrt inertial
     Vec3 w;   // angular rate in body frame [rad/s]
+    Vec3 h{0.0, 0.0, 0.0};  // reaction wheel (rotor) angular momentum in body frame [N·m·s]
 };
 
 } // namespace starSense
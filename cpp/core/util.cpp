@@ -14,57 +14,6 @@ Vec3 normalize(const Vec3 &v) {
     return Vec3{v[0] * invNorm, v[1] * invNorm, v[2] * invNorm};
 }
 
-Quat normalize(const Quat &q) {
-    double norm2 =
-        q[0]*q[0] +
-        q[1]*q[1] +
-        q[2]*q[2] +
-        q[3]*q[3];
-
-    if (norm2 == 0.0) {
-        // Degenerate – return identity quaternion
-        return Quat{1.0, 0.0, 0.0, 0.0};
-    }
-
-    double invNorm = 1.0 / std::sqrt(norm2);
-    return Quat{
-        q[0] * invNorm,
-        q[1] * invNorm,
-        q[2] * invNorm,
-        q[3] * invNorm
-    };
-}
-
-// Basic vector ops
-
-double dot(const Vec3 &a, const Vec3 &b) {
-    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
-}
-
-Vec3 cross(const Vec3 &a, const Vec3 &b) {
-    return Vec3{
-        a[1]*b[2] - a[2]*b[1],
-        a[2]*b[0] - a[0]*b[2],
-        a[0]*b[1] - a[1]*b[0]
-    };
-}
-
-Vec3 add(const Vec3 &a, const Vec3 &b) {
-    return Vec3{
-        a[0] + b[0],
-        a[1] + b[1],
-        a[2] + b[2]
-    };
-}
-
-Vec3 sub(const Vec3 &a, const Vec3 &b) {
-    return Vec3{
-        a[0] - b[0],
-        a[1] - b[1],
-        a[2] - b[2]
-    };
-}
-
 // 3x3 matrix ops
 
 Mat3 transpose(const Mat3 &A) {
@@ -91,14 +40,6 @@ Mat3 matmul(const Mat3 &A, const Mat3 &B) {
     return C;
 }
 
-Vec3 matmul(const Mat3 &A, const Vec3 &v) {
-    Vec3 out{};
-    for (std::size_t i = 0; i < 3; ++i) {
-        out[i] = A[i][0]*v[0] + A[i][1]*v[1] + A[i][2]*v[2];
-    }
-    return out;
-}
-
 Vec3 matmul(const Vec3 &v, const Mat3 &A) {
     Vec3 out{};
     for (std::size_t j = 0; j < 3; ++j) {
@@ -138,20 +79,22 @@ Mat3 inverse(const Mat3 &A) {
 }
 
 // Quaternion helpers
-Quat quatConjugate(const Quat &q) {
-    return Quat{ q[0], -q[1], -q[2], -q[3] };
-}
 
-Quat quatMultiply(const Quat &a, const Quat &b) {
-    const double aw = a[0], ax = a[1], ay = a[2], az = a[3];
-    const double bw = b[0], bx = b[1], by = b[2], bz = b[3];
+Quat quatFromRotationVector(const Vec3 &phi) {
+    const double angle2 = phi[0]*phi[0] + phi[1]*phi[1] + phi[2]*phi[2];
+    const double angle = std::sqrt(angle2);
+
+    // sin(angle/2)/angle, with a Taylor series near zero to avoid 0/0
+    double c, s;
+    if (angle < 1e-4) {
+        c = 1.0 - angle2 / 8.0;
+        s = 0.5 - angle2 / 48.0;
+    } else {
+        c = std::cos(0.5 * angle);
+        s = std::sin(0.5 * angle) / angle;
+    }
 
-    return Quat{
-        aw*bw - ax*bx - ay*by - az*bz,
-        aw*bx + ax*bw + ay*bz - az*by,
-        aw*by - ax*bz + ay*bw + az*bx,
-        aw*bz + ax*by - ay*bx + az*bw
-    };
+    return Quat{ c, s * phi[0], s * phi[1], s * phi[2] };
 }
 
 } // namespace starSense
@@ -13,17 +13,59 @@ namespace starSense {
 // Vector normalization
 // ------------------------------
 Vec3 normalize(const Vec3 &v);
-Quat normalize(const Quat &q);
+
+inline Quat normalize(const Quat &q) {
+    double norm2 =
+        q[0]*q[0] +
+        q[1]*q[1] +
+        q[2]*q[2] +
+        q[3]*q[3];
+
+    if (norm2 == 0.0) {
+        // Degenerate – return identity quaternion
+        return Quat{1.0, 0.0, 0.0, 0.0};
+    }
+
+    double invNorm = 1.0 / std::sqrt(norm2);
+    return Quat{
+        q[0] * invNorm,
+        q[1] * invNorm,
+        q[2] * invNorm,
+        q[3] * invNorm
+    };
+}
 
 // ------------------------------
 // Basic vector ops
 // ------------------------------
-double dot(const Vec3 &a, const Vec3 &b);
-Vec3   cross(const Vec3 &a, const Vec3 &b);
+inline double dot(const Vec3 &a, const Vec3 &b) {
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+inline Vec3 cross(const Vec3 &a, const Vec3 &b) {
+    return Vec3{
+        a[1]*b[2] - a[2]*b[1],
+        a[2]*b[0] - a[0]*b[2],
+        a[0]*b[1] - a[1]*b[0]
+    };
+}
 
 // Component-wise add/sub
-Vec3 add(const Vec3 &a, const Vec3 &b);
-Vec3 sub(const Vec3 &a, const Vec3 &b);
+inline Vec3 add(const Vec3 &a, const Vec3 &b) {
+    return Vec3{
+        a[0] + b[0],
+        a[1] + b[1],
+        a[2] + b[2]
+    };
+}
+
+inline Vec3 sub(const Vec3 &a, const Vec3 &b) {
+    return Vec3{
+        a[0] - b[0],
+        a[1] - b[1],
+        a[2] - b[2]
+    };
+}
 
 // ------------------------------
 // 3x3 matrix ops
@@ -34,7 +76,13 @@ Mat3 transpose(const Mat3 &A);
 Mat3 matmul(const Mat3 &A, const Mat3 &B);
 
 // A * v  (3x3 * 3x1)
-Vec3 matmul(const Mat3 &A, const Vec3 &v);
+inline Vec3 matmul(const Mat3 &A, const Vec3 &v) {
+    Vec3 out{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        out[i] = A[i][0]*v[0] + A[i][1]*v[1] + A[i][2]*v[2];
+    }
+    return out;
+}
 
 // v * A  (1x3 * 3x3) – treat v as row vector
 Vec3 matmul(const Vec3 &v, const Mat3 &A);
@@ -45,7 +93,23 @@ Mat3 inverse(const Mat3 &A);
 // ------------------------------
 // Quaternion helpers
 // ------------------------------
-Quat quatConjugate(const Quat &q);
-Quat quatMultiply(const Quat &a, const Quat &b);
+inline Quat quatConjugate(const Quat &q) {
+    return Quat{ q[0], -q[1], -q[2], -q[3] };
+}
+
+inline Quat quatMultiply(const Quat &a, const Quat &b) {
+    const double aw = a[0], ax = a[1], ay = a[2], az = a[3];
+    const double bw = b[0], bx = b[1], by = b[2], bz = b[3];
+
+    return Quat{
+        aw*bw - ax*bx - ay*by - az*bz,
+        aw*bx + ax*bw + ay*bz - az*by,
+        aw*by - ax*bz + ay*bw + az*bx,
+        aw*bz + ax*by - ay*bx + az*bw
+    };
+}
+
+// Exponential map: unit quaternion of the rotation by |phi| about phi/|phi|
+Quat quatFromRotationVector(const Vec3 &phi);
 
 } // namespace starSense
@@ -0,0 +1,144 @@
+#include "wheelAllocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace starSense {
+
+WheelAllocator::WheelAllocator(const std::vector<Vec3> &axes)
+    : n_(axes.size()),
+      ax_(n_), ay_(n_), az_(n_),
+      px_(n_), py_(n_), pz_(n_)
+{
+    for (std::size_t i = 0; i < n_; ++i) {
+        const Vec3 a = normalize(axes[i]);
+        ax_[i] = a[0];
+        ay_[i] = a[1];
+        az_[i] = a[2];
+    }
+
+    // Orthonormal basis Q of the torque directions the wheels span (Gram-
+    // Schmidt over the axes). Rows past rank_ stay zero.
+    Mat3 Q{};
+    for (std::size_t i = 0; i < n_ && rank_ < 3; ++i) {
+        Vec3 v{ax_[i], ay_[i], az_[i]};
+        for (std::size_t k = 0; k < rank_; ++k) {
+            const double c = dot(v, Q[k]);
+            for (std::size_t r = 0; r < 3; ++r) {
+                v[r] -= c * Q[k][r];
+            }
+        }
+        if (std::sqrt(dot(v, v)) > kRankTolerance) {
+            Q[rank_++] = normalize(v);
+        }
+    }
+
+    // M = A Aᵀ is singular below full rank, so invert it on the span instead:
+    // M⁺ = Qᵀ (Q M Qᵀ)⁻¹ Q. The unused rows of Q are zero, and padding
+    // Q M Qᵀ with ones on their diagonal keeps it invertible without
+    // changing M⁺.
+    Mat3 M{};
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double a[3] = {ax_[i], ay_[i], az_[i]};
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 3; ++c) {
+                M[r][c] += a[r] * a[c];
+            }
+        }
+    }
+    Mat3 reduced = matmul(matmul(Q, M), transpose(Q));
+    for (std::size_t k = rank_; k < 3; ++k) {
+        reduced[k][k] = 1.0;
+    }
+    const Mat3 Mpinv = matmul(matmul(transpose(Q), inverse(reduced)), Q);
+
+    // A⁺ = Aᵀ M⁺: row i is a_iᵀ M⁺
+    for (std::size_t i = 0; i < n_; ++i) {
+        const Vec3 row = matmul(Vec3{ax_[i], ay_[i], az_[i]}, Mpinv);
+        px_[i] = row[0];
+        py_[i] = row[1];
+        pz_[i] = row[2];
+    }
+}
+
+void WheelAllocator::allocate(const Vec3 &tau, double *u) const {
+    const double tx = tau[0], ty = tau[1], tz = tau[2];
+    const double *px = px_.data();
+    const double *py = py_.data();
+    const double *pz = pz_.data();
+    for (std::size_t i = 0; i < n_; ++i) {
+        u[i] = px[i] * tx + py[i] * ty + pz[i] * tz;
+    }
+}
+
+void WheelAllocator::nullSpaceCorrection(const double *dh, double gain, double *v) const {
+    // The null space is empty when every wheel adds a torque direction
+    if (n_ == rank_ || gain == 0.0) {
+        for (std::size_t i = 0; i < n_; ++i) {
+            v[i] = 0.0;
+        }
+        return;
+    }
+
+    // (I - A⁺A) dh = dh - A⁺ (A dh)
+    const Vec3 Adh = bodyTorque(dh);
+    const double *px = px_.data();
+    const double *py = py_.data();
+    const double *pz = pz_.data();
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double range = px[i] * Adh[0] + py[i] * Adh[1] + pz[i] * Adh[2];
+        v[i] = gain * (dh[i] - range);
+    }
+}
+
+double WheelAllocator::saturate(double *u, const double *invLimit) const {
+    double worst = 0.0;
+    for (std::size_t i = 0; i < n_; ++i) {
+        worst = std::max(worst, std::abs(u[i]) * invLimit[i]);
+    }
+    if (worst <= 1.0) {
+        return 1.0;
+    }
+    const double scale = 1.0 / worst;
+    for (std::size_t i = 0; i < n_; ++i) {
+        u[i] *= scale;
+    }
+    return scale;
+}
+
+double WheelAllocator::addWithinLimits(double *u, const double *v, const double *limit) const {
+    // Common case: the full correction fits
+    bool fits = true;
+    for (std::size_t i = 0; i < n_; ++i) {
+        fits &= std::abs(u[i] + v[i]) <= limit[i];
+    }
+
+    // Otherwise each wheel bounds alpha by the distance to the limit it
+    // moves toward
+    double alpha = 1.0;
+    if (!fits) {
+        for (std::size_t i = 0; i < n_; ++i) {
+            if (v[i] != 0.0) {
+                const double room = std::copysign(limit[i], v[i]) - u[i];
+                alpha = std::min(alpha, room / v[i]);
+            }
+        }
+        alpha = std::max(alpha, 0.0);
+    }
+    for (std::size_t i = 0; i < n_; ++i) {
+        u[i] += alpha * v[i];
+    }
+    return alpha;
+}
+
+Vec3 WheelAllocator::bodyTorque(const double *u) const {
+    double tx = 0.0, ty = 0.0, tz = 0.0;
+    for (std::size_t i = 0; i < n_; ++i) {
+        tx += ax_[i] * u[i];
+        ty += ay_[i] * u[i];
+        tz += az_[i] * u[i];
+    }
+    return Vec3{tx, ty, tz};
+}
+
+} // namespace starSense
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "types.hpp"
+#include "util.hpp"
+
+namespace starSense {
+
+// Maps a body torque onto an array of N reaction wheels.
+//
+// With A the 3xN matrix of unit spin axes, the minimum-norm wheel torques
+// realizing tau are u = A⁺ tau, A⁺ = Aᵀ (A Aᵀ)⁻¹ (Moore–Penrose). For a
+// redundant array (e.g. a 4-wheel pyramid) the extra N-3 directions form the
+// null space of A: wheel torques there change the wheel momenta without
+// torquing the body, which is what momentum management uses.
+//
+// Under-actuated arrays (one or two wheels, or coplanar axes) span fewer
+// than three torque directions. A A^T is then singular and A⁺ is its
+// least-squares form: A u is the part of tau in the span of the axes, and
+// the rest of tau is not realized.
+//
+// A⁺ is built once at construction; the null-space projector I - A⁺A is
+// applied as dh - A⁺(A dh), which is O(N) instead of the O(N²) of a stored
+// projector. Everything is stored as flat contiguous arrays indexed by
+// wheel, so the per-call loops are short unit-stride loops the compiler
+// vectorizes, and a 4-12 wheel array costs little more than 3 wheels.
+class WheelAllocator {
+public:
+    // axes: spin axis of each wheel in the body frame (normalized here)
+    explicit WheelAllocator(const std::vector<Vec3> &axes);
+
+    std::size_t size() const { return n_; }
+
+    // Number of independent torque directions (3 unless under-actuated)
+    std::size_t rank() const { return rank_; }
+
+    // u = A⁺ tau (u has size() entries)
+    void allocate(const Vec3 &tau, double *u) const;
+
+    // v = gain * (I - A⁺A) dh: torques on the body (A v = 0, so none in
+    // total) whose reaction on the wheels, -v, drives the null-space part of
+    // the wheel momentum error dh [N·m·s] to zero. v may alias dh.
+    void nullSpaceCorrection(const double *dh, double gain, double *v) const;
+
+    // Scale u uniformly so that |u_i| <= limit_i for every wheel. Unlike
+    // clamping each wheel separately this keeps the direction of the body
+    // torque A u. Returns the scale factor applied (1 if within limits).
+    double saturate(double *u, const double *invLimit) const;
+
+    // u += alpha * v with the largest alpha in [0, 1] that keeps
+    // |u_i| <= limit_i, given u already within limits. Used to fit the
+    // null-space correction into the torque left over by the command, so
+    // momentum management never costs attitude control authority.
+    // Returns alpha.
+    double addWithinLimits(double *u, const double *v, const double *limit) const;
+
+    // Body torque A u
+    Vec3 bodyTorque(const double *u) const;
+
+    // Unit spin axis of wheel i
+    Vec3 axis(std::size_t i) const { return Vec3{ax_[i], ay_[i], az_[i]}; }
+
+private:
+    // Axes within this distance of the span of the previous ones add no
+    // direction (a nearly coplanar array would otherwise need huge torques)
+    static constexpr double kRankTolerance = 1e-4;
+
+    std::size_t n_;
+    std::size_t rank_ = 0;
+    std::vector<double> ax_, ay_, az_;  // A, by row
+    std::vector<double> px_, py_, pz_;  // A⁺, by column
+};
+
+} // namespace starSense
@@ -1,4 +1,5 @@
 #include "api.hpp"
+#include "paramsJson.hpp"
 
 namespace starSense {
 
@@ -41,6 +42,13 @@ void validateInertia(const Mat3 &J,
 
 // Check for valid timestep
 void validateTimestep(const AttitudeSimParams& params) {
+    // Adaptive integration picks its own step; dt is only the logging grid.
+    // The Lie-group step propagates attitude through the exponential map,
+    // so large rotations per step are not a problem for it.
+    if (params.integratorType == "rk45" || params.integratorType == "rkmk4") {
+        return;
+    }
+
     double wx = params.w0[0];
     double wy = params.w0[1];
     double wz = params.w0[2];
@@ -65,15 +73,30 @@ void validateTimestep(const AttitudeSimParams& params) {
     }
 }
 
+// ----------------------------------------------------------
+// Component selection
+//
+// Each withX() resolves one string type to a concrete component and hands it
+// to fn by value. Nesting them instantiates one StaticAttitudeSimulation per
+// type combination, so the string dispatch happens once per run and the step
+// loop itself contains no virtual calls.
+// ----------------------------------------------------------
+
 // Build controller from params
-std::unique_ptr<Controller> makeController(
-    const std::string &controllerType, Vec3 kpAtt, Vec3 kdRate, double controlRateHz, Mat3x6 kLqr) {
+template <typename Fn>
+auto withController(const AttitudeSimParams &params, Fn &&fn) {
+    const std::string &controllerType = params.controllerType;
     if (controllerType == "zero") {
-        return std::make_unique<ZeroController>();
+        return fn(ZeroController{});
     } else if (controllerType == "pd") {
-        return std::make_unique<PDController>(kpAtt, kdRate, controlRateHz);
+        return fn(PDController(params.kpAtt, params.kdRate));
     } else if (controllerType == "lqr") {
-        return std::make_unique<LQRController>(kLqr, controlRateHz);
+        return fn(LQRController(params.kLqr));
+    } else if (controllerType == "lqr_auto") {
+        // Gain synthesized from the Q/R weights instead of taken from kLqr
+        const Mat3x6 gain = lqrAttitudeGain(
+            params.inertiaBody, params.lqrAttWeights, params.lqrRateWeights, params.lqrTorqueWeights);
+        return fn(LQRController(gain));
     } else {
         throw std::invalid_argument(
             "runSimulation: unsupported controllerType = " + controllerType);
@@ -81,28 +104,68 @@ std::unique_ptr<Controller> makeController(
 }
 
 // Build sensor from params
-std::unique_ptr<Sensor> makeSensor(const std::string &sensorType) {
-    if (sensorType == "ideal") {
-        return std::make_unique<IdealAttitudeSensor>();
+template <typename Fn>
+auto withSensor(const AttitudeSimParams &params, Fn &&fn) {
+    if (params.sensorType == "ideal") {
+        return fn(IdealAttitudeSensor{});
+    } else if (params.sensorType == "noisy") {
+        if (params.noiseSeed < 0 || params.caseId < 0) {
+            throw std::invalid_argument("runSimulation: noiseSeed and caseId must be >= 0");
+        }
+        NoisySensorParams noise;
+        noise.seed = static_cast<std::uint32_t>(params.noiseSeed);
+        noise.caseId = static_cast<std::uint32_t>(params.caseId);
+        noise.starTrackerNoise = params.starTrackerNoise;
+        noise.starTrackerBias = params.starTrackerBias;
+        noise.gyroNoise = params.gyroNoise;
+        noise.gyroBias0 = params.gyroBias0;
+        noise.gyroBiasRandomWalk = params.gyroBiasRandomWalk;
+        return fn(NoisyAttitudeSensor(noise));
+    } else {
+        throw std::invalid_argument(
+            "runSimulation: unsupported sensorType = " + params.sensorType
+        );
+    }
+}
+
+// Build estimator from params. The MEKF reuses the sensor noise model as
+// its process/measurement noise.
+template <typename Fn>
+auto withEstimator(const AttitudeSimParams &params, Fn &&fn) {
+    if (params.estimatorType == "none") {
+        return fn(PassThroughEstimator{});
+    } else if (params.estimatorType == "mekf") {
+        MekfParams mekf;
+        // The filter needs a nonzero measurement noise, even with a
+        // noiseless star tracker
+        mekf.starTrackerNoise = std::max(params.starTrackerNoise, 1e-6);
+        mekf.gyroNoise = params.gyroNoise;
+        mekf.gyroBiasRandomWalk = params.gyroBiasRandomWalk;
+        mekf.initialAttitudeSigma = params.mekfInitialAttSigma;
+        mekf.initialBiasSigma = params.mekfInitialBiasSigma;
+        return fn(MekfEstimator(mekf));
     } else {
         throw std::invalid_argument(
-            "runSimulation: unsupported sensorType = " + sensorType
+            "runSimulation: unsupported estimatorType = " + params.estimatorType
         );
     }
 }
 
 // Build actuator from params
-std::unique_ptr<Actuator> makeActuator(const AttitudeSimParams &params) {
+template <typename Fn>
+auto withActuator(const AttitudeSimParams &params, Fn &&fn) {
     if (params.actuatorType == "ideal") {
-        return std::make_unique<IdealTorqueActuator>();
+        return fn(IdealTorqueActuator{});
     } else if (params.actuatorType == "reactionWheel") {
-        return std::make_unique<ReactionWheelActuator>(
+        return fn(ReactionWheelActuator(
             params.wheelAxes,
             params.wheelInertias,
             params.maxWheelTorque,
             params.maxWheelSpeed,
-            params.wheelSpeeds0
-        );
+            params.wheelSpeeds0,
+            params.nullSpaceGain,
+            params.wheelSpeedsTarget
+        ));
     } else {
         throw std::invalid_argument(
             "runSimulation: unsupported actuatorType = " + params.actuatorType
@@ -110,16 +173,36 @@ std::unique_ptr<Actuator> makeActuator(const AttitudeSimParams &params) {
     }
 }
 
+// Build integrator from params; the method becomes a template argument
+template <typename Fn>
+auto withIntegrator(const AttitudeSimParams &params, Fn &&fn) {
+    const IntegratorTolerances tolerances{params.absTol, params.relTol};
+    if (params.integratorType == "euler") {
+        return fn(StaticIntegrator<IntegrationMethod::Euler>(tolerances));
+    } else if (params.integratorType == "rk4") {
+        return fn(StaticIntegrator<IntegrationMethod::RK4>(tolerances));
+    } else if (params.integratorType == "rk45") {
+        return fn(StaticIntegrator<IntegrationMethod::RK45>(tolerances));
+    } else if (params.integratorType == "rkmk4") {
+        return fn(StaticIntegrator<IntegrationMethod::RKMK4>(tolerances));
+    } else {
+        throw std::invalid_argument(
+            "runSimulation: unsupported integratorType = " + params.integratorType);
+    }
+}
+
 // build the reference profile from params
-std::unique_ptr<ReferenceProfile> makeReferenceProfile(
+template <typename Fn>
+auto withReferenceProfile(
     const std::string& referenceType,
     const Quat& qRef,
-    const Vec3& wRef
+    const Vec3& wRef,
+    Fn &&fn
 ) {
     if (referenceType == "fixed") {
-        return std::make_unique<ConstantReferenceProfile>(qRef);
+        return fn(ConstantReferenceProfile(qRef));
     } else if (referenceType == "spinning") {
-        return std::make_unique<SpinningReferenceProfile>(wRef);
+        return fn(SpinningReferenceProfile(wRef));
     } else {
         throw std::invalid_argument(
             "runSimulation: unsupported referenceType = " + referenceType
@@ -128,54 +211,251 @@ std::unique_ptr<ReferenceProfile> makeReferenceProfile(
 }
 
 SimulationResult runSimulation(const AttitudeSimParams &params) {
+    return runSimulation(params, ResultSink{});
+}
+
+ChannelLayout channelLayout(const AttitudeSimParams &params) {
+    ChannelLayout layout;
+    layout.numWheels = (params.actuatorType == "reactionWheel") ? params.wheelAxes.size() : 0;
+    layout.derived = params.derivedChannels;
+    return layout;
+}
+
+SimulationResult runSimulation(const AttitudeSimParams &params, const ResultSink &sink) {
     // Validate inputs
     validateInertia(params.inertiaBody);
-    validateTimestep(params);  // NOTE: In the future switch to an adaptive step integrator
+    validateTimestep(params);
 
-    // Build dynamics
-    auto dynamics = std::make_unique<RigidBodyDynamics>(params.inertiaBody);
+    // Build dynamics, with the environment tabulated once for the whole run
+    std::shared_ptr<const DisturbanceModel> disturbances;
+    if (params.gravityGradient || params.aeroDrag || params.solarPressure || params.magneticDipole) {
+        OrbitElements elements;
+        elements.semiMajorAxis = params.orbitSemiMajorAxis;
+        elements.eccentricity = params.orbitEccentricity;
+        elements.inclination = params.orbitInclination;
+        elements.raan = params.orbitRaan;
+        elements.argPerigee = params.orbitArgPerigee;
+        elements.meanAnomaly = params.orbitMeanAnomaly;
+        const KeplerOrbit orbit(elements, params.orbitJ2);
 
-    // Build integrator
-    IntegrationMethod method;
-    if (params.integratorType == "euler") {
-        method = IntegrationMethod::Euler;
-    } else if (params.integratorType == "rk4") {
-        method = IntegrationMethod::RK4;
-    } else {
+        DisturbanceParams dist;
+        dist.gravityGradient = params.gravityGradient;
+        dist.aeroDrag = params.aeroDrag;
+        dist.solarPressure = params.solarPressure;
+        dist.magneticDipole = params.magneticDipole;
+        dist.inertia = params.inertiaBody;
+        dist.dragArea = params.dragArea;
+        dist.dragCoefficient = params.dragCoefficient;
+        dist.srpArea = params.srpArea;
+        dist.srpReflectivity = params.srpReflectivity;
+        dist.centerOfPressure = params.centerOfPressure;
+        dist.residualDipole = params.residualDipole;
+
+        disturbances = std::make_shared<const DisturbanceModel>(
+            dist,
+            EnvironmentTable(orbit, params.sunLongitude0,
+                             params.dt * static_cast<double>(params.numSteps),
+                             params.environmentUpdateInterval));
+    }
+    // Reaction wheels exchange momentum with the body rather than apply an
+    // external torque
+    const ControlTorqueSource torqueSource = (params.actuatorType == "reactionWheel")
+        ? ControlTorqueSource::Wheels : ControlTorqueSource::External;
+    RigidBodyDynamics dynamics(params.inertiaBody, disturbances, torqueSource);
+
+    if (params.logEvery < 1 || params.logChunkSize < 1) {
         throw std::invalid_argument(
-            "runSimulation: unsupported integratorType = " + params.integratorType);
+            "runSimulation: logEvery and logChunkSize must be >= 1");
     }
-    auto integrator = std::make_unique<Integrator>(method);
 
-    // Build controller
-    auto controller = makeController(params.controllerType, params.kpAtt, params.kdRate, params.controlRateHz, params.kLqr);
+    SimulationConfig cfg{params.dt, params.numSteps};
+    cfg.logging.decimation = params.logEvery;
+    cfg.logging.chunkSize = static_cast<std::size_t>(params.logChunkSize);
+    cfg.logging.sink = sink;
+    cfg.derived.enabled = params.derivedChannels;
+    cfg.derived.inertia = params.inertiaBody;
+    cfg.logging.summaryOnly = params.summaryOnly;
+    cfg.summary.enabled = params.summaryMetrics || params.summaryOnly;
+    cfg.summary.settlingAttitudeError = params.settlingAttitudeError;
+    cfg.summary.settlingRateError = params.settlingRateError;
+    cfg.summary.rmsStartTime = params.rmsStartTime;
+    AttitudeState x0{params.q0, params.w0};
 
-    // Build sensor
-    auto sensor = makeSensor(params.sensorType);
+    // Task rates as whole numbers of dt steps. The zero controller's output
+    // never changes, so it runs once. An actuator without a rate of its own
+    // follows the controller, except that reaction wheels with momentum
+    // management change their torque on their own and keep running every
+    // step. Speed limits need no extra calls: applyCommand already limits a
+    // held torque up to the next call (holdUntil). With the zero controller
+    // an adaptive integrator then takes the whole run as one interval.
+    // An ideal sensor without an estimator keeps no state and only the
+    // controller reads it, so without a rate of its own it runs with the
+    // controller instead of on every step.
+    const bool constantCommand = (params.controllerType == "zero");
+    const bool wheelsSelfUpdate = (params.actuatorType == "reactionWheel") && params.nullSpaceGain > 0.0;
+    const bool statelessSensing = (params.sensorType == "ideal") && (params.estimatorType == "none");
+    cfg.schedule.controller = constantCommand
+        ? 0 : MultiRateScheduler::periodFromRate(params.controlRateHz, params.dt, "controlRateHz");
+    if (params.sensorRateHz <= 0.0 && statelessSensing) {
+        cfg.schedule.sensor = cfg.schedule.controller;
+    } else {
+        cfg.schedule.sensor = MultiRateScheduler::periodFromRate(params.sensorRateHz, params.dt, "sensorRateHz");
+    }
+    if (params.actuatorRateHz > 0.0) {
+        cfg.schedule.actuator =
+            MultiRateScheduler::periodFromRate(params.actuatorRateHz, params.dt, "actuatorRateHz");
+    } else if (cfg.schedule.controller == 0 && wheelsSelfUpdate) {
+        cfg.schedule.actuator = 1;
+    } else {
+        cfg.schedule.actuator = cfg.schedule.controller;
+    }
+
+    if (params.eventAttitudeError > 0.0) {
+        cfg.events.push_back(attitudeErrorBelowEvent(params.eventAttitudeError, params.stopOnEvent));
+    }
+    if (params.eventRateError > 0.0) {
+        cfg.events.push_back(rateErrorBelowEvent(params.eventRateError, params.stopOnEvent));
+    }
+    if (params.eventWheelSpeedLimit && channelLayout(params).numWheels > 0) {
+        cfg.events.push_back(wheelSpeedLimitEvent(params.maxWheelSpeed, params.stopOnEvent));
+    }
+
+    // Optional trajectory file: written chunk by chunk while the run is in
+    // progress, alongside any caller-provided sink
+    std::unique_ptr<TrajectoryWriter> writer;
+    if (!params.trajectoryPath.empty()) {
+        if (params.summaryOnly) {
+            throw std::invalid_argument(
+                "runSimulation: summaryOnly logs no samples to write to trajectoryPath");
+        }
+        writer = std::make_unique<TrajectoryWriter>(
+            params.trajectoryPath,
+            ResultLogger::sampleCount(params.numSteps, params.logEvery),
+            paramsToJson(params),
+            params.trajectoryFloat32 ? TrajectoryDtype::Float32 : TrajectoryDtype::Float64,
+            channelLayout(params)
+        );
+        cfg.logging.sink = [&writer, &sink](const SimulationResult &chunk) {
+            writer->write(chunk);
+            if (sink) {
+                sink(chunk);
+            }
+        };
+    }
 
-    // Build actuator
-    auto actuator = makeActuator(params);
+    // Resolve integrator, controller, sensor, estimator, actuator and
+    // reference once, then run the statically composed simulation
+    SimulationResult result = withIntegrator(params, [&](auto integrator) {
+        return withController(params, [&](auto controller) {
+        return withSensor(params, [&](auto sensor) {
+        return withEstimator(params, [&](auto estimator) {
+        return withActuator(params, [&](auto actuator) {
+        return withReferenceProfile(params.referenceType, params.qRef, params.wRef, [&](auto refProvider) {
+            StaticAttitudeSimulation<
+                RigidBodyDynamics,
+                decltype(integrator),
+                decltype(controller),
+                decltype(sensor),
+                decltype(estimator),
+                decltype(actuator),
+                decltype(refProvider)
+            > sim(
+                dynamics,
+                std::move(integrator),
+                std::move(controller),
+                std::move(sensor),
+                std::move(estimator),
+                std::move(actuator),
+                std::move(refProvider)
+            );
 
-    // Reference: constant attitude equal to initial for now
-    auto refProvider = makeReferenceProfile(params.referenceType, params.qRef, params.wRef);
+            return sim.run(cfg, x0);
+        });
+        });
+        });
+        });
+        });
+    });
 
-    // Construct simulation object
-    AttitudeSimulation sim(
-        std::move(dynamics),
-        std::move(integrator),
-        std::move(controller),
-        std::move(sensor),
-        std::move(actuator),
-        std::move(refProvider)
-    );
+    if (writer) {
+        writer->close();
+    }
 
-    SimulationConfig cfg{params.dt, params.numSteps};
-    AttitudeState x0{params.q0, params.w0};
+    return result;
+}
+
+std::vector<SimulationResult> runSimulationBatch(
+    const std::vector<AttitudeSimParams> &cases,
+    int numThreads
+) {
+    // Each case builds its own dynamics/controller/actuator, so cases share
+    // no mutable state and can run on any worker. Writing into a pre-sized
+    // vector keeps the output in input order.
+    std::vector<SimulationResult> results(cases.size());
 
-    // Run the simulation
-    SimulationResult simResult = sim.run(cfg, x0);
+    parallelFor(cases.size(), numThreads, [&](std::size_t i) {
+        results[i] = runSimulation(cases[i]);
+    });
+
+    return results;
+}
+
+DispersionStatistics runDispersionBatch(
+    const std::vector<AttitudeSimParams> &cases,
+    DispersionConfig config,
+    int numThreads
+) {
+    if (cases.empty()) {
+        throw std::invalid_argument("runDispersionBatch: no cases");
+    }
+
+    const ChannelLayout layout = channelLayout(cases.front());
+    double tMax = 0.0;
+    for (const AttitudeSimParams &params : cases) {
+        const ChannelLayout caseLayout = channelLayout(params);
+        if (caseLayout.numWheels != layout.numWheels || caseLayout.derived != layout.derived) {
+            throw std::invalid_argument(
+                "runDispersionBatch: every case must log the same channels (wheel count, derivedChannels)");
+        }
+        if (params.summaryOnly) {
+            throw std::invalid_argument("runDispersionBatch: summaryOnly cases log no samples");
+        }
+        tMax = std::max(tMax, params.numSteps * params.dt);
+    }
+
+    // By default one bin per logged sample of the first case, widened so the
+    // longest case spans at most kDefaultDispersionBins bins (each t-digest
+    // costs a few KB, so one per sample of a long run would not fit)
+    if (config.binWidth <= 0.0) {
+        config.binWidth = cases.front().dt * std::max(cases.front().logEvery, 1);
+        const std::size_t maxBins = (config.numBins == 0) ? kDefaultDispersionBins : config.numBins;
+        if (maxBins > 1 && tMax / config.binWidth + 1.0 > static_cast<double>(maxBins)) {
+            config.binWidth = tMax / static_cast<double>(maxBins - 1);
+        }
+    }
+    if (config.numBins == 0) {
+        config.numBins = static_cast<std::size_t>(std::floor(tMax / config.binWidth + 0.5)) + 1;
+    }
+
+    // Per-worker accumulators: no locking while the runs stream
+    const std::size_t numWorkers = resolveWorkerCount(numThreads, cases.size());
+    std::vector<DispersionAccumulator> accumulators(numWorkers, DispersionAccumulator(config, layout));
+
+    parallelForWorkers(cases.size(), numThreads, [&](std::size_t worker, std::size_t i) {
+        DispersionAccumulator &acc = accumulators[worker];
+        runSimulation(cases[i], [&acc](const SimulationResult &chunk) { acc.addChunk(chunk); });
+        acc.runDone();
+    });
+
+    for (std::size_t w = 1; w < numWorkers; ++w) {
+        accumulators.front().merge(accumulators[w]);
+    }
+    return accumulators.front().statistics();
+}
 
-    return simResult;
+ThreadPool &simulationPool() {
+    static ThreadPool pool;
+    return pool;
 }
 
 } // namespace starSense
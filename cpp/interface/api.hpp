@@ -9,17 +9,23 @@
 #include "dynamics.hpp"
 #include "integrator.hpp"
 #include "sensor.hpp"
+#include "estimator.hpp"
 #include "actuator.hpp"
 #include "controller.hpp"
+#include "lqr.hpp"
+#include "ensemble.hpp"
 #include "util.hpp"
 #include "referenceProfile.hpp"
+#include "parallel.hpp"
+#include "trajectoryFile.hpp"
+#include "dispersion.hpp"
 
 namespace starSense {
 
 struct AttitudeSimParams {
     // Initial state
-    Quat q0;      // [w, x, y, z]
-    Vec3 w0;      // [wx, wy, wz] in body frame [rad/s]
+    Quat q0{1.0, 0.0, 0.0, 0.0};  // [w, x, y, z]
+    Vec3 w0{0.0, 0.0, 0.0};       // [wx, wy, wz] in body frame [rad/s]
 
     // Spacecraft properties
     Mat3 inertiaBody{  // full 3x3 inertia matrix in body frame - default unit cube
@@ -32,11 +38,37 @@ struct AttitudeSimParams {
     double dt = 0.1;         // step [s]
     int    numSteps = 1000;  // number of steps
 
+    // Logging
+    int logEvery = 1;              // keep every k-th grid sample (the final sample is always kept)
+    int logChunkSize = 4096;       // rows per chunk when streaming to a sink
+    bool derivedChannels = false;  // also log Euler angles, error norms, energy and momentum
+
+    // Trajectory file (empty: none). When set, logged samples are streamed
+    // to this file during the run and the returned result carries no samples.
+    std::string trajectoryPath;
+    bool trajectoryFloat32 = false;  // store channels (except time) as float32
+
+    // Run summary (SimulationResult::summary, see summary.hpp)
+    bool summaryMetrics = false;           // accumulate the scalar metrics
+    bool summaryOnly = false;              // log no samples, only the summary (implies summaryMetrics)
+    double settlingAttitudeError = 0.01;   // rad, settling band on |attitude error| (<= 0: no settling time)
+    double settlingRateError = 0.0;        // rad/s, settling band on |rate error| as well (<= 0: off)
+    double rmsStartTime = 0.0;             // s, RMS attitude error over t >= this
+
+    // Events, located inside the integrator step and listed in
+    // SimulationResult::events (see events.hpp)
+    double eventAttitudeError = 0.0;     // rad, |attitude error| falls below (<= 0: off)
+    double eventRateError = 0.0;         // rad/s, |rate error| falls below (<= 0: off)
+    bool eventWheelSpeedLimit = false;   // a reaction wheel reaches maxWheelSpeed
+    bool stopOnEvent = false;            // end the run at the first of the events above
+
     // Integrator
-    std::string integratorType = "rk4";   // "euler" or "rk4"
+    std::string integratorType = "rk4";   // "euler", "rk4", "rk45" (adaptive; steps end on actuator ticks) or "rkmk4" (Lie group)
+    double absTol = 1e-9;                 // rk45 absolute error tolerance
+    double relTol = 1e-6;                 // rk45 relative error tolerance
 
     // Controller selection
-    std::string controllerType = "zero";                // "zero", "pd", and "lqr" supported
+    std::string controllerType = "zero";                // "zero", "pd", "lqr" (kLqr) or "lqr_auto" (weights below)
     Vec3 kpAtt = std::array<double,3>{1.0, 1.0, 1.0};   // defaults
     Vec3 kdRate = std::array<double,3>{1.0, 1.0, 1.0};  // defaults
     Mat3x6 kLqr = {{                                    // defaults
@@ -44,13 +76,41 @@ struct AttitudeSimParams {
         {{1.0, 1.0, 1.0, 1.0, 1.0, 1.0}},
         {{1.0, 1.0, 1.0, 1.0, 1.0, 1.0}}
     }};
-    double controlRateHz = dt;
+    double controlRateHz = 0.0;   // Hz, 1/rate a whole number of dt steps (<= 0: every step)
+
+    // LQR weights used by "lqr_auto": Q = diag(att, rate), R = diag(torque)
+    Vec3 lqrAttWeights = std::array<double,3>{1.0, 1.0, 1.0};
+    Vec3 lqrRateWeights = std::array<double,3>{1.0, 1.0, 1.0};
+    Vec3 lqrTorqueWeights = std::array<double,3>{1.0, 1.0, 1.0};
 
     // Sensor selection
-    std::string sensorType = "ideal";     // only "ideal" is supported right now
+    std::string sensorType = "ideal";     // "ideal" or "noisy"
+    double sensorRateHz = 0.0;            // Hz, sensor + estimator rate (<= 0: every step)
+
+    // Noisy sensor parameters (used when sensorType = "noisy"). Noise is a
+    // pure function of (noiseSeed, caseId, measurement index): give each
+    // Monte Carlo case its own caseId and it reproduces exactly, in any
+    // batch order and on any number of threads.
+    int noiseSeed = 0;
+    int caseId = 0;
+    double starTrackerNoise = 0.0;                         // rad, 1σ per axis
+    Vec3 starTrackerBias = std::array<double,3>{0.0, 0.0, 0.0};  // rad, fixed misalignment
+    double gyroNoise = 0.0;                                // rad/s, 1σ per axis per sample
+    Vec3 gyroBias0 = std::array<double,3>{0.0, 0.0, 0.0};  // rad/s, initial gyro bias
+    double gyroBiasRandomWalk = 0.0;                       // rad/s/√s, bias drift
+
+    // Estimator selection
+    std::string estimatorType = "none";   // "none" (raw measurements) or "mekf"
+
+    // MEKF parameters (used when estimatorType = "mekf"). The filter's noise
+    // model is the sensor's: starTrackerNoise, gyroNoise, gyroBiasRandomWalk.
+    double mekfInitialAttSigma = 1e-2;    // rad, initial attitude uncertainty
+    double mekfInitialBiasSigma = 1e-3;   // rad/s, initial gyro bias uncertainty
 
     // Actuator selection
     std::string actuatorType = "ideal";   // "ideal" or "reactionWheel"
+    double actuatorRateHz = 0.0;          // Hz (<= 0: with the controller; reaction wheels with
+                                          // nullSpaceGain > 0 under the zero controller run every step)
 
     // Reaction wheel parameters (used when actuatorType = "reactionWheel")
     std::vector<Vec3> wheelAxes = {       // spin axis for each wheel in body frame (normalized)
@@ -62,14 +122,80 @@ struct AttitudeSimParams {
     std::vector<double> maxWheelTorque = {0.1, 0.1, 0.1};     // N·m (torque saturation per wheel)
     std::vector<double> maxWheelSpeed = {6000, 6000, 6000};   // RPM (speed saturation per wheel)
     std::vector<double> wheelSpeeds0 = {0.0, 0.0, 0.0};       // RPM (initial wheel speeds)
+    double nullSpaceGain = 0.0;               // 1/s, null-space momentum management (0: off; needs > 3 wheels)
+    std::vector<double> wheelSpeedsTarget;    // RPM, null-space speed targets (empty: all zero)
+
+    // Environmental disturbance torques (all off by default)
+    bool gravityGradient = false;
+    bool aeroDrag = false;
+    bool solarPressure = false;
+    bool magneticDipole = false;
+    double environmentUpdateInterval = 10.0;  // s, orbit/Sun/density/field sampled at this spacing and interpolated
+
+    // Orbit at t = 0 (Keplerian with secular J2 drift), angles in rad
+    double orbitSemiMajorAxis = 6778137.0;  // m
+    double orbitEccentricity = 0.0;
+    double orbitInclination = 0.9;
+    double orbitRaan = 0.0;
+    double orbitArgPerigee = 0.0;
+    double orbitMeanAnomaly = 0.0;
+    bool orbitJ2 = true;
+    double sunLongitude0 = 0.0;             // rad, Sun ecliptic longitude at t = 0 (0: March equinox)
+
+    // Spacecraft surface and magnetic properties
+    double dragArea = 1.0;                  // m²
+    double dragCoefficient = 2.2;
+    double srpArea = 1.0;                   // m²
+    double srpReflectivity = 1.3;           // 1 absorbing, 2 mirror
+    Vec3 centerOfPressure = std::array<double,3>{0.05, 0.0, 0.0};  // m, from the centre of mass (body)
+    Vec3 residualDipole = std::array<double,3>{0.1, 0.0, 0.0};     // A·m² (body)
 
     // Reference profile selection
     std::string referenceType = "fixed";  // only fixed is supported right now
-    Quat qRef;
-    Vec3 wRef;
+    Quat qRef{1.0, 0.0, 0.0, 0.0};
+    Vec3 wRef{0.0, 0.0, 0.0};
 };
 
 // Single, general entrypoint
 SimulationResult runSimulation(const AttitudeSimParams &params);
 
+// Streaming variant: logged samples are passed to `sink` in chunks of
+// params.logChunkSize rows as the run progresses; the returned result
+// carries no samples (only run-level data such as integrator stats).
+SimulationResult runSimulation(const AttitudeSimParams &params, const ResultSink &sink);
+
+// Optional channels a run with these params logs: the reaction wheels it
+// logs speeds for (the width of SimulationResult::wheelSpeeds) and whether
+// derived telemetry is on
+ChannelLayout channelLayout(const AttitudeSimParams &params);
+
+// Run many independent cases on a pool of worker threads.
+//  cases      : one parameter set per case
+//  numThreads : worker count (<= 0 uses one per hardware thread)
+// Returns one result per case, in the same order as `cases`.
+std::vector<SimulationResult> runSimulationBatch(
+    const std::vector<AttitudeSimParams> &cases,
+    int numThreads = 0
+);
+
+// Run many cases in parallel and return time-aligned envelopes of their
+// logged channels instead of the runs themselves (see dispersion.hpp).
+// Each run streams its samples into its worker's accumulators, which are
+// merged at the end, so memory does not grow with the number of cases.
+//  config     : channels and quantiles; binWidth <= 0 uses the first case's
+//               logging interval (dt * logEvery), widened if needed so the
+//               longest case fits in numBins (kDefaultDispersionBins when 0)
+//               bins; numBins = 0 covers the longest case
+//  numThreads : worker count (<= 0 uses one per hardware thread)
+// Every case must log the same channels (channelLayout) and keep samples.
+DispersionStatistics runDispersionBatch(
+    const std::vector<AttitudeSimParams> &cases,
+    DispersionConfig config = {},
+    int numThreads = 0
+);
+
+// Process-wide worker pool for queued runs (one worker per hardware thread,
+// created on first use); the Python run_simulation_async submits to it
+ThreadPool &simulationPool();
+
 } // namespace starSense
@@ -1,9 +1,181 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>  
+#include <pybind11/numpy.h>
+#include <pybind11/functional.h>
 #include "api.hpp"
+#include "paramsFile.hpp"
+#include "paramsJson.hpp"
+#include "sweep.hpp"
+#include "optimizer.hpp"
 
 namespace py = pybind11;
 
+// Expose a logged channel as a read-only NumPy view of shape (N, Width).
+// No data is copied: the array borrows the SimulationResult buffer and holds
+// a reference to `owner` so the result outlives every view of it.
+template <std::size_t Width>
+py::array arrayView(const starSense::Series<Width> &series, py::handle owner) {
+    py::array arr(
+        py::dtype::of<double>(),
+        {series.size(), Width},
+        {Width * sizeof(double), sizeof(double)},
+        series.data.data(),
+        owner
+    );
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// 1-D variant for the time vector
+py::array arrayView(const std::vector<double> &values, py::handle owner) {
+    py::array arr(
+        py::dtype::of<double>(),
+        {values.size()},
+        {sizeof(double)},
+        values.data(),
+        owner
+    );
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// Run-time width variant (wheel speeds): shape (N, width)
+py::array arrayView(const starSense::DynamicSeries &series, py::handle owner) {
+    py::array arr(
+        py::dtype::of<double>(),
+        {series.size(), series.width},
+        {series.width * sizeof(double), sizeof(double)},
+        series.data.data(),
+        owner
+    );
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// Read-only NumPy view of one memory-mapped trajectory channel: (rows, width),
+// or (rows,) for scalar channels. The array keeps the TrajectoryFile alive.
+py::array trajectoryView(const starSense::TrajectoryChannel &channel, py::handle owner) {
+    const py::dtype dtype = (channel.dtype == starSense::TrajectoryDtype::Float32)
+        ? py::dtype::of<float>()
+        : py::dtype::of<double>();
+    const std::size_t itemSize = static_cast<std::size_t>(channel.dtype);
+
+    std::vector<py::ssize_t> shape{static_cast<py::ssize_t>(channel.rows)};
+    std::vector<py::ssize_t> strides{static_cast<py::ssize_t>(channel.width * itemSize)};
+    if (channel.width > 1) {
+        shape.push_back(static_cast<py::ssize_t>(channel.width));
+        strides.push_back(static_cast<py::ssize_t>(itemSize));
+    }
+
+    py::array arr(dtype, shape, strides, channel.data, owner);
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// Owns the Python future of a queued run. The task (and so the handle) is
+// destroyed on whichever thread drops it last, usually a worker, so the
+// reference is released with the GIL held.
+class PyFutureHandle {
+public:
+    explicit PyFutureHandle(py::object future) : future_(new py::object(std::move(future))) { }
+
+    PyFutureHandle(PyFutureHandle &&other) noexcept : future_(other.future_) { other.future_ = nullptr; }
+    PyFutureHandle(const PyFutureHandle &) = delete;
+    PyFutureHandle &operator=(const PyFutureHandle &) = delete;
+    PyFutureHandle &operator=(PyFutureHandle &&) = delete;
+
+    ~PyFutureHandle() {
+        if (future_) {
+            py::gil_scoped_acquire gil;
+            delete future_;
+        }
+    }
+
+    // Only with the GIL held
+    py::object &get() const { return *future_; }
+
+private:
+    py::object *future_;
+};
+
+// Fail a Python future with `type(message)`; with the GIL held. If the
+// future cannot take it (it is already done), report the error as
+// unraisable rather than lose it.
+void setFutureException(py::object &future, const char *type, const std::string &message) {
+    try {
+        future.attr("set_exception")(py::module_::import("builtins").attr(type)(message));
+    } catch (py::error_already_set &e) {
+        e.discard_as_unraisable("run_simulation_async");
+    }
+}
+
+// Queue one run on the C++ simulation pool and return a
+// concurrent.futures.Future for it, so Python can use as_completed(), wait(),
+// add_done_callback() or asyncio.wrap_future() on the handle. The worker
+// takes the GIL only to mark the future running and to publish the outcome;
+// the simulation itself runs without it.
+py::object runSimulationAsync(const starSense::AttitudeSimParams &params) {
+    py::object future = py::module_::import("concurrent.futures").attr("Future")();
+
+    try {
+        starSense::simulationPool().submit([params, handle = PyFutureHandle(future)]() {
+            {
+                py::gil_scoped_acquire gil;
+                try {
+                    if (!handle.get().attr("set_running_or_notify_cancel")().cast<bool>()) {
+                        return;  // cancelled while queued
+                    }
+                } catch (py::error_already_set &e) {
+                    setFutureException(handle.get(), "RuntimeError", e.what());
+                    return;
+                }
+            }
+
+            starSense::SimulationResult result;
+            std::string error;
+            bool invalidArgument = false;
+            try {
+                result = starSense::runSimulation(params);
+            } catch (const std::invalid_argument &e) {
+                error = e.what();
+                invalidArgument = true;
+            } catch (const std::exception &e) {
+                error = e.what();
+            } catch (...) {
+                error = "run_simulation_async: unknown error";
+            }
+
+            py::gil_scoped_acquire gil;
+            if (!error.empty()) {
+                // Same mapping pybind11 applies to synchronous calls
+                setFutureException(handle.get(), invalidArgument ? "ValueError" : "RuntimeError", error);
+                return;
+            }
+            try {
+                handle.get().attr("set_result")(py::cast(std::move(result)));
+            } catch (py::error_already_set &e) {
+                setFutureException(handle.get(), "RuntimeError", e.what());
+            }
+        });
+    } catch (const std::exception &e) {
+        // The pool is shutting down: the future still completes, with the error
+        if (future.attr("set_running_or_notify_cancel")().cast<bool>()) {
+            setFutureException(future, "RuntimeError", e.what());
+        }
+    }
+
+    return future;
+}
+
+// Property getter returning a zero-copy view of one SimulationResult member
+template <typename Member>
+auto resultView(Member member) {
+    return [member](py::object self) {
+        const auto &result = self.cast<const starSense::SimulationResult &>();
+        return arrayView(result.*member, self);
+    };
+}
+
 PYBIND11_MODULE(starSense, m) {
     m.doc() = "StarSense attitude simulation bindings";
 
@@ -17,43 +189,462 @@ PYBIND11_MODULE(starSense, m) {
         // Simulation configuration
         .def_readwrite("dt", &starSense::AttitudeSimParams::dt)
         .def_readwrite("numSteps", &starSense::AttitudeSimParams::numSteps)
+        .def_readwrite("logEvery", &starSense::AttitudeSimParams::logEvery)
+        .def_readwrite("logChunkSize", &starSense::AttitudeSimParams::logChunkSize)
+        .def_readwrite("derivedChannels", &starSense::AttitudeSimParams::derivedChannels)
+        .def_readwrite("trajectoryPath", &starSense::AttitudeSimParams::trajectoryPath)
+        .def_readwrite("trajectoryFloat32", &starSense::AttitudeSimParams::trajectoryFloat32)
+        .def_readwrite("summaryMetrics", &starSense::AttitudeSimParams::summaryMetrics)
+        .def_readwrite("summaryOnly", &starSense::AttitudeSimParams::summaryOnly)
+        .def_readwrite("settlingAttitudeError", &starSense::AttitudeSimParams::settlingAttitudeError)
+        .def_readwrite("settlingRateError", &starSense::AttitudeSimParams::settlingRateError)
+        .def_readwrite("rmsStartTime", &starSense::AttitudeSimParams::rmsStartTime)
+        .def_readwrite("eventAttitudeError", &starSense::AttitudeSimParams::eventAttitudeError)
+        .def_readwrite("eventRateError", &starSense::AttitudeSimParams::eventRateError)
+        .def_readwrite("eventWheelSpeedLimit", &starSense::AttitudeSimParams::eventWheelSpeedLimit)
+        .def_readwrite("stopOnEvent", &starSense::AttitudeSimParams::stopOnEvent)
         .def_readwrite("integratorType", &starSense::AttitudeSimParams::integratorType)
+        .def_readwrite("absTol", &starSense::AttitudeSimParams::absTol)
+        .def_readwrite("relTol", &starSense::AttitudeSimParams::relTol)
         // Controller configuration
         .def_readwrite("controllerType", &starSense::AttitudeSimParams::controllerType)
         .def_readwrite("kpAtt", &starSense::AttitudeSimParams::kpAtt)
         .def_readwrite("kdRate", &starSense::AttitudeSimParams::kdRate)
         .def_readwrite("kLqr", &starSense::AttitudeSimParams::kLqr)
         .def_readwrite("controlRateHz", &starSense::AttitudeSimParams::controlRateHz)
+        .def_readwrite("lqrAttWeights", &starSense::AttitudeSimParams::lqrAttWeights)
+        .def_readwrite("lqrRateWeights", &starSense::AttitudeSimParams::lqrRateWeights)
+        .def_readwrite("lqrTorqueWeights", &starSense::AttitudeSimParams::lqrTorqueWeights)
         // Reference profile
         .def_readwrite("wRef", &starSense::AttitudeSimParams::wRef)
         .def_readwrite("qRef", &starSense::AttitudeSimParams::qRef)
         .def_readwrite("referenceType", &starSense::AttitudeSimParams::referenceType)
         // Sensors and actuators
         .def_readwrite("sensorType", &starSense::AttitudeSimParams::sensorType)
+        .def_readwrite("sensorRateHz", &starSense::AttitudeSimParams::sensorRateHz)
+        .def_readwrite("noiseSeed", &starSense::AttitudeSimParams::noiseSeed)
+        .def_readwrite("caseId", &starSense::AttitudeSimParams::caseId)
+        .def_readwrite("starTrackerNoise", &starSense::AttitudeSimParams::starTrackerNoise)
+        .def_readwrite("starTrackerBias", &starSense::AttitudeSimParams::starTrackerBias)
+        .def_readwrite("gyroNoise", &starSense::AttitudeSimParams::gyroNoise)
+        .def_readwrite("gyroBias0", &starSense::AttitudeSimParams::gyroBias0)
+        .def_readwrite("gyroBiasRandomWalk", &starSense::AttitudeSimParams::gyroBiasRandomWalk)
+        .def_readwrite("estimatorType", &starSense::AttitudeSimParams::estimatorType)
+        .def_readwrite("mekfInitialAttSigma", &starSense::AttitudeSimParams::mekfInitialAttSigma)
+        .def_readwrite("mekfInitialBiasSigma", &starSense::AttitudeSimParams::mekfInitialBiasSigma)
         .def_readwrite("actuatorType", &starSense::AttitudeSimParams::actuatorType)
+        .def_readwrite("actuatorRateHz", &starSense::AttitudeSimParams::actuatorRateHz)
         // Reaction wheel parameters
         .def_readwrite("wheelAxes", &starSense::AttitudeSimParams::wheelAxes)
         .def_readwrite("wheelInertias", &starSense::AttitudeSimParams::wheelInertias)
         .def_readwrite("maxWheelTorque", &starSense::AttitudeSimParams::maxWheelTorque)
         .def_readwrite("maxWheelSpeed", &starSense::AttitudeSimParams::maxWheelSpeed)
-        .def_readwrite("wheelSpeeds0", &starSense::AttitudeSimParams::wheelSpeeds0);
+        .def_readwrite("wheelSpeeds0", &starSense::AttitudeSimParams::wheelSpeeds0)
+        .def_readwrite("nullSpaceGain", &starSense::AttitudeSimParams::nullSpaceGain)
+        .def_readwrite("wheelSpeedsTarget", &starSense::AttitudeSimParams::wheelSpeedsTarget)
+        // Environmental disturbances
+        .def_readwrite("gravityGradient", &starSense::AttitudeSimParams::gravityGradient)
+        .def_readwrite("aeroDrag", &starSense::AttitudeSimParams::aeroDrag)
+        .def_readwrite("solarPressure", &starSense::AttitudeSimParams::solarPressure)
+        .def_readwrite("magneticDipole", &starSense::AttitudeSimParams::magneticDipole)
+        .def_readwrite("environmentUpdateInterval", &starSense::AttitudeSimParams::environmentUpdateInterval)
+        .def_readwrite("orbitSemiMajorAxis", &starSense::AttitudeSimParams::orbitSemiMajorAxis)
+        .def_readwrite("orbitEccentricity", &starSense::AttitudeSimParams::orbitEccentricity)
+        .def_readwrite("orbitInclination", &starSense::AttitudeSimParams::orbitInclination)
+        .def_readwrite("orbitRaan", &starSense::AttitudeSimParams::orbitRaan)
+        .def_readwrite("orbitArgPerigee", &starSense::AttitudeSimParams::orbitArgPerigee)
+        .def_readwrite("orbitMeanAnomaly", &starSense::AttitudeSimParams::orbitMeanAnomaly)
+        .def_readwrite("orbitJ2", &starSense::AttitudeSimParams::orbitJ2)
+        .def_readwrite("sunLongitude0", &starSense::AttitudeSimParams::sunLongitude0)
+        .def_readwrite("dragArea", &starSense::AttitudeSimParams::dragArea)
+        .def_readwrite("dragCoefficient", &starSense::AttitudeSimParams::dragCoefficient)
+        .def_readwrite("srpArea", &starSense::AttitudeSimParams::srpArea)
+        .def_readwrite("srpReflectivity", &starSense::AttitudeSimParams::srpReflectivity)
+        .def_readwrite("centerOfPressure", &starSense::AttitudeSimParams::centerOfPressure)
+        .def_readwrite("residualDipole", &starSense::AttitudeSimParams::residualDipole);
 
-    // Simulation Result
+    // Config files (same formats as starSense_cli)
+    m.def("load_params_file", &starSense::loadParamsFile, py::arg("path"),
+          "Read a list of AttitudeSimParams from a JSON, JSON Lines or TOML config file");
+    m.def("params_to_json", &starSense::paramsToJson, py::arg("params"),
+          "Serialize AttitudeSimParams as a JSON object (readable by load_params_file)");
+
+    // Integrator work counters
+    py::class_<starSense::IntegratorStats>(m, "IntegratorStats")
+        .def_readonly("acceptedSteps", &starSense::IntegratorStats::acceptedSteps)
+        .def_readonly("rejectedSteps", &starSense::IntegratorStats::rejectedSteps);
+
+    // Located event crossing
+    py::class_<starSense::EventOccurrence>(m, "EventOccurrence")
+        .def_readonly("name", &starSense::EventOccurrence::name)
+        .def_readonly("t", &starSense::EventOccurrence::t)
+        .def("__repr__", [](const starSense::EventOccurrence &e) {
+            return "EventOccurrence(" + e.name + ", t=" + std::to_string(e.t) + ")";
+        });
+
+    // Scalar metrics of one run
+    py::class_<starSense::SimulationSummary>(m, "SimulationSummary")
+        .def_readonly("samples",               &starSense::SimulationSummary::samples)
+        .def_readonly("endTime",               &starSense::SimulationSummary::endTime)
+        .def_readonly("settlingTime",          &starSense::SimulationSummary::settlingTime)
+        .def_readonly("peakAttitudeError",     &starSense::SimulationSummary::peakAttitudeError)
+        .def_readonly("peakAttitudeErrorTime", &starSense::SimulationSummary::peakAttitudeErrorTime)
+        .def_readonly("peakRateError",         &starSense::SimulationSummary::peakRateError)
+        .def_readonly("rmsAttitudeError",      &starSense::SimulationSummary::rmsAttitudeError)
+        .def_readonly("finalAttitudeError",    &starSense::SimulationSummary::finalAttitudeError)
+        .def_readonly("finalRateError",        &starSense::SimulationSummary::finalRateError)
+        .def_readonly("controlImpulse",        &starSense::SimulationSummary::controlImpulse)
+        .def_readonly("saturationTime",        &starSense::SimulationSummary::saturationTime)
+        .def_readonly("maxWheelSpeed",         &starSense::SimulationSummary::maxWheelSpeed);
+
+    // Simulation Result (channels are read-only NumPy views, no copies)
     py::class_<starSense::SimulationResult>(m, "SimulationResult")
-        .def_readonly("time",            &starSense::SimulationResult::time)
-        .def_readonly("quats",           &starSense::SimulationResult::quats)
-        .def_readonly("omegas",          &starSense::SimulationResult::omegas)
-        .def_readonly("commandedTorque", &starSense::SimulationResult::commandedTorque)
-        .def_readonly("appliedTorque",   &starSense::SimulationResult::appliedTorque)
-        .def_readonly("qRef",            &starSense::SimulationResult::qRef)
-        .def_readonly("wRef",            &starSense::SimulationResult::wRef)
-        .def_readonly("attitudeError",   &starSense::SimulationResult::attitudeError)
-        .def_readonly("rateError",       &starSense::SimulationResult::rateError);
+        .def_property_readonly("time",            resultView(&starSense::SimulationResult::time))
+        .def_property_readonly("quats",           resultView(&starSense::SimulationResult::quats))
+        .def_property_readonly("omegas",          resultView(&starSense::SimulationResult::omegas))
+        .def_property_readonly("commandedTorque", resultView(&starSense::SimulationResult::commandedTorque))
+        .def_property_readonly("appliedTorque",   resultView(&starSense::SimulationResult::appliedTorque))
+        .def_property_readonly("qRef",            resultView(&starSense::SimulationResult::qRef))
+        .def_property_readonly("wRef",            resultView(&starSense::SimulationResult::wRef))
+        .def_property_readonly("attitudeError",   resultView(&starSense::SimulationResult::attitudeError))
+        .def_property_readonly("rateError",       resultView(&starSense::SimulationResult::rateError))
+        .def_property_readonly("wheelMomentum",   resultView(&starSense::SimulationResult::wheelMomentum))
+        .def_property_readonly("wheelSpeeds",     resultView(&starSense::SimulationResult::wheelSpeeds))
+        .def_property_readonly("eulerAngles",       resultView(&starSense::SimulationResult::eulerAngles))
+        .def_property_readonly("attitudeErrorNorm", resultView(&starSense::SimulationResult::attitudeErrorNorm))
+        .def_property_readonly("rateErrorNorm",     resultView(&starSense::SimulationResult::rateErrorNorm))
+        .def_property_readonly("kineticEnergy",     resultView(&starSense::SimulationResult::kineticEnergy))
+        .def_property_readonly("angularMomentum",   resultView(&starSense::SimulationResult::angularMomentum))
+        .def_readonly("integratorStats",          &starSense::SimulationResult::integratorStats)
+        .def_readonly("events",                   &starSense::SimulationResult::events)
+        .def_readonly("summary",                  &starSense::SimulationResult::summary)
+        .def_readonly("terminated",               &starSense::SimulationResult::terminated);
+
+    // Trajectory file reader (memory-mapped; channels are read-only views)
+    py::class_<starSense::TrajectoryFile>(m, "TrajectoryFile")
+        .def(py::init<const std::string &>(), py::arg("path"))
+        .def_property_readonly("metadata", &starSense::TrajectoryFile::metadata)
+        .def_property_readonly("channels", [](const starSense::TrajectoryFile &file) {
+            std::vector<std::string> names;
+            for (const auto &c : file.channels()) {
+                names.push_back(c.name);
+            }
+            return names;
+        })
+        .def_property_readonly("chunks", [](const starSense::TrajectoryFile &file) {
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> chunks;
+            for (const auto &c : file.chunks()) {
+                chunks.emplace_back(c.firstRow, c.rows);
+            }
+            return chunks;
+        })
+        .def("__getitem__", [](py::object self, const std::string &name) {
+            const auto &file = self.cast<const starSense::TrajectoryFile &>();
+            try {
+                return trajectoryView(file.channel(name), self);
+            } catch (const std::out_of_range &e) {
+                throw py::key_error(e.what());
+            }
+        }, py::arg("name"));
+
+    // Lock-step ensemble propagation (many cases per kernel call)
+    py::class_<starSense::EnsembleCase>(m, "EnsembleCase")
+        .def(py::init<>())
+        .def_readwrite("q0", &starSense::EnsembleCase::q0)
+        .def_readwrite("w0", &starSense::EnsembleCase::w0)
+        .def_readwrite("inertia", &starSense::EnsembleCase::inertia)
+        .def_readwrite("qRef", &starSense::EnsembleCase::qRef)
+        .def_readwrite("wRef", &starSense::EnsembleCase::wRef)
+        .def_readwrite("gain", &starSense::EnsembleCase::gain);
+
+    py::class_<starSense::EnsembleResult>(m, "EnsembleResult")
+        .def_property_readonly("quats", [](py::object self) {
+            return arrayView(self.cast<const starSense::EnsembleResult &>().quats, self);
+        })
+        .def_property_readonly("omegas", [](py::object self) {
+            return arrayView(self.cast<const starSense::EnsembleResult &>().omegas, self);
+        });
+
+    m.def("pd_gain_matrix", &starSense::pdGainMatrix, py::arg("kp_att"), py::arg("kd_rate"),
+          "Ensemble gain equivalent to a PD controller: [diag(kp), diag(kd)]");
+
+    m.def(
+        "propagate_ensemble",
+        [](const std::vector<starSense::EnsembleCase> &cases, double dt, int numSteps,
+           double controlRateHz, int numThreads) {
+            return starSense::propagateEnsemble(
+                cases, starSense::EnsembleConfig{dt, numSteps, controlRateHz}, numThreads);
+        },
+        py::arg("cases"),
+        py::arg("dt"),
+        py::arg("num_steps"),
+        py::arg("control_rate_hz") = 0.0,
+        py::arg("num_threads") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Propagate many cases in lock-step with SIMD RK4; returns the final states in input order"
+    );
+
+    // Counter-based noise: the same normals the noisy sensor draws, for
+    // sample indices [first, first + count) of one stream -> (count, 4)
+    m.def(
+        "philox_normals",
+        [](std::uint32_t seed, std::uint32_t caseId, std::uint32_t stream,
+           std::uint64_t first, std::size_t count) {
+            py::array_t<double> out({count, std::size_t{4}});
+            double *data = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                starSense::fillPhiloxNormals(starSense::philoxKey(seed, caseId), stream, first, count, data);
+            }
+            return out;
+        },
+        py::arg("seed"),
+        py::arg("case_id"),
+        py::arg("stream"),
+        py::arg("first"),
+        py::arg("count"),
+        "Standard normals from Philox4x32-10 keyed by (seed, case_id); row j is sample first + j"
+    );
+
+    // Native LQR gain synthesis (same model as python/lqr_utils.py)
+    m.def(
+        "lqr_attitude_gain",
+        &starSense::lqrAttitudeGain,
+        py::arg("inertia"),
+        py::arg("q_weights"),
+        py::arg("w_weights"),
+        py::arg("r_weights"),
+        "LQR gain K (3x6, tau = -K [phi; e_w]) for diagonal Q/R weights"
+    );
 
     // Main entrypoint
     m.def(
         "run_simulation",
-        &starSense::runSimulation,
+        py::overload_cast<const starSense::AttitudeSimParams &>(&starSense::runSimulation),
+        py::arg("params"),
+        py::call_guard<py::gil_scoped_release>(),
         "Run a rigid-body attitude simulation"
     );
+
+    // Streaming entrypoint: sink(chunk) receives SimulationResult chunks of
+    // params.logChunkSize rows while the run progresses
+    m.def(
+        "run_simulation",
+        py::overload_cast<const starSense::AttitudeSimParams &, const starSense::ResultSink &>(
+            &starSense::runSimulation),
+        py::arg("params"),
+        py::arg("sink"),
+        py::call_guard<py::gil_scoped_release>(),  // the sink wrapper re-acquires it per chunk
+        "Run a rigid-body attitude simulation, streaming logged samples to sink in chunks"
+    );
+
+    // Asynchronous entrypoint: returns a concurrent.futures.Future immediately
+    m.def(
+        "run_simulation_async",
+        &runSimulationAsync,
+        py::arg("params"),
+        "Queue a simulation on the internal C++ worker pool and return a concurrent.futures.Future"
+    );
+
+    // Let queued async runs finish (they need the GIL to publish results)
+    // before the interpreter shuts down
+    m.def(
+        "wait_async_idle",
+        []() { starSense::simulationPool().waitIdle(); },
+        py::call_guard<py::gil_scoped_release>(),
+        "Block until every queued run_simulation_async call has finished"
+    );
+    py::module_::import("atexit").attr("register")(m.attr("wait_async_idle"));
+
+    // Batch entrypoint: cases run in parallel with the GIL released
+    m.def(
+        "run_simulation_batch",
+        &starSense::runSimulationBatch,
+        py::arg("cases"),
+        py::arg("num_threads") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Run many attitude simulations in parallel; results are returned in input order"
+    );
+
+    // Monte Carlo dispersion envelopes (series are read-only NumPy views)
+    py::class_<starSense::DispersionConfig>(m, "DispersionConfig")
+        .def(py::init<>())
+        .def_readwrite("channels", &starSense::DispersionConfig::channels)
+        .def_readwrite("quantiles", &starSense::DispersionConfig::quantiles)
+        .def_readwrite("binWidth", &starSense::DispersionConfig::binWidth)
+        .def_readwrite("numBins", &starSense::DispersionConfig::numBins)
+        .def_readwrite("compression", &starSense::DispersionConfig::compression);
+
+    py::class_<starSense::ChannelEnvelope>(m, "ChannelEnvelope")
+        .def_readonly("name", &starSense::ChannelEnvelope::name)
+        .def_readonly("width", &starSense::ChannelEnvelope::width)
+        .def_readonly("count", &starSense::ChannelEnvelope::count)
+        .def_property_readonly("mean", [](py::object self) {
+            return arrayView(self.cast<const starSense::ChannelEnvelope &>().mean, self);
+        })
+        .def_property_readonly("stddev", [](py::object self) {
+            return arrayView(self.cast<const starSense::ChannelEnvelope &>().stddev, self);
+        })
+        .def_property_readonly("quantiles", [](py::object self) {
+            py::list out;
+            for (const auto &series : self.cast<const starSense::ChannelEnvelope &>().quantiles) {
+                out.append(arrayView(series, self));
+            }
+            return out;
+        });
+
+    py::class_<starSense::DispersionStatistics>(m, "DispersionStatistics")
+        .def_property_readonly("time", [](py::object self) {
+            return arrayView(self.cast<const starSense::DispersionStatistics &>().time, self);
+        })
+        .def_readonly("quantiles", &starSense::DispersionStatistics::quantiles)
+        .def_readonly("runs", &starSense::DispersionStatistics::runs)
+        .def_property_readonly("channels", [](const starSense::DispersionStatistics &stats) {
+            std::vector<std::string> names;
+            for (const auto &c : stats.channels) {
+                names.push_back(c.name);
+            }
+            return names;
+        })
+        .def("__getitem__", [](const starSense::DispersionStatistics &stats, const std::string &name)
+                -> const starSense::ChannelEnvelope & {
+            try {
+                return stats.channel(name);
+            } catch (const std::out_of_range &e) {
+                throw py::key_error(e.what());
+            }
+        }, py::arg("name"), py::return_value_policy::reference_internal);
+
+    m.def(
+        "run_dispersion_batch",
+        &starSense::runDispersionBatch,
+        py::arg("cases"),
+        py::arg("config") = starSense::DispersionConfig{},
+        py::arg("num_threads") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Run many simulations in parallel and return per-time-bin mean, stddev and quantile "
+        "envelopes of their channels (no run is kept)"
+    );
+
+    // Parameter sweeps / design of experiments
+    py::class_<starSense::SweepAxis>(m, "SweepAxis")
+        .def(py::init<>())
+        .def(py::init([](const std::string &param, const std::string &kind, std::vector<double> values,
+                         double lo, double hi, int index, bool scale) {
+                 starSense::SweepAxis axis;
+                 axis.param = param;
+                 axis.kind = kind;
+                 axis.values = std::move(values);
+                 axis.lo = lo;
+                 axis.hi = hi;
+                 axis.index = index;
+                 axis.scale = scale;
+                 return axis;
+             }),
+             py::arg("param"), py::arg("kind") = "grid", py::arg("values") = std::vector<double>{},
+             py::arg("lo") = 0.0, py::arg("hi") = 1.0, py::arg("index") = -1, py::arg("scale") = false)
+        .def_readwrite("param", &starSense::SweepAxis::param)
+        .def_readwrite("index", &starSense::SweepAxis::index)
+        .def_readwrite("kind", &starSense::SweepAxis::kind)
+        .def_readwrite("values", &starSense::SweepAxis::values)
+        .def_readwrite("lo", &starSense::SweepAxis::lo)
+        .def_readwrite("hi", &starSense::SweepAxis::hi)
+        .def_readwrite("scale", &starSense::SweepAxis::scale);
+
+    py::class_<starSense::SweepSpec>(m, "SweepSpec")
+        .def(py::init<>())
+        .def_readwrite("base", &starSense::SweepSpec::base)
+        .def_readwrite("axes", &starSense::SweepSpec::axes)
+        .def_readwrite("samples", &starSense::SweepSpec::samples)
+        .def_readwrite("seed", &starSense::SweepSpec::seed)
+        .def_readwrite("perCaseNoise", &starSense::SweepSpec::perCaseNoise);
+
+    py::class_<starSense::SweepCase>(m, "SweepCase")
+        .def_readonly("index", &starSense::SweepCase::index)
+        .def_readonly("coordinates", &starSense::SweepCase::coordinates)
+        .def_readonly("summary", &starSense::SweepCase::summary)
+        .def_readonly("error", &starSense::SweepCase::error);
+
+    py::class_<starSense::ParameterSweep>(m, "ParameterSweep")
+        .def(py::init<starSense::SweepSpec>(), py::arg("spec"))
+        .def("__len__", &starSense::ParameterSweep::size)
+        .def("coordinates", &starSense::ParameterSweep::coordinates, py::arg("i"))
+        .def("params", &starSense::ParameterSweep::params, py::arg("i"));
+
+    m.def(
+        "run_sweep",
+        &starSense::runSweep,
+        py::arg("spec"),
+        py::arg("num_threads") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Run every case of a parameter sweep in parallel and return each case's coordinates and summary"
+    );
+
+    // Closed-loop gain optimization (CMA-ES over batched runs)
+    py::class_<starSense::OptimizerVariable>(m, "OptimizerVariable")
+        .def(py::init<>())
+        .def(py::init([](const std::string &param, double lo, double hi, double initial,
+                         int index, bool logScale, bool scale) {
+                 starSense::OptimizerVariable v;
+                 v.param = param;
+                 v.lo = lo;
+                 v.hi = hi;
+                 v.initial = initial;
+                 v.index = index;
+                 v.logScale = logScale;
+                 v.scale = scale;
+                 return v;
+             }),
+             py::arg("param"), py::arg("lo"), py::arg("hi"),
+             py::arg("initial") = std::numeric_limits<double>::quiet_NaN(), py::arg("index") = -1,
+             py::arg("logScale") = false, py::arg("scale") = false)
+        .def_readwrite("param", &starSense::OptimizerVariable::param)
+        .def_readwrite("index", &starSense::OptimizerVariable::index)
+        .def_readwrite("lo", &starSense::OptimizerVariable::lo)
+        .def_readwrite("hi", &starSense::OptimizerVariable::hi)
+        .def_readwrite("initial", &starSense::OptimizerVariable::initial)
+        .def_readwrite("logScale", &starSense::OptimizerVariable::logScale)
+        .def_readwrite("scale", &starSense::OptimizerVariable::scale);
+
+    py::class_<starSense::GainCost>(m, "GainCost")
+        .def(py::init<>())
+        .def_readwrite("settlingTime", &starSense::GainCost::settlingTime)
+        .def_readwrite("rmsAttitudeError", &starSense::GainCost::rmsAttitudeError)
+        .def_readwrite("peakAttitudeError", &starSense::GainCost::peakAttitudeError)
+        .def_readwrite("finalAttitudeError", &starSense::GainCost::finalAttitudeError)
+        .def_readwrite("controlImpulse", &starSense::GainCost::controlImpulse)
+        .def_readwrite("saturationTime", &starSense::GainCost::saturationTime)
+        .def_readwrite("wheelSpeed", &starSense::GainCost::wheelSpeed);
+
+    py::class_<starSense::GainOptimizationSpec>(m, "GainOptimizationSpec")
+        .def(py::init<>())
+        .def_readwrite("cases", &starSense::GainOptimizationSpec::cases)
+        .def_readwrite("variables", &starSense::GainOptimizationSpec::variables)
+        .def_readwrite("cost", &starSense::GainOptimizationSpec::cost)
+        .def_readwrite("populationSize", &starSense::GainOptimizationSpec::populationSize)
+        .def_readwrite("maxGenerations", &starSense::GainOptimizationSpec::maxGenerations)
+        .def_readwrite("sigma0", &starSense::GainOptimizationSpec::sigma0)
+        .def_readwrite("xTolerance", &starSense::GainOptimizationSpec::xTolerance)
+        .def_readwrite("seed", &starSense::GainOptimizationSpec::seed)
+        .def_readwrite("numThreads", &starSense::GainOptimizationSpec::numThreads);
+
+    py::class_<starSense::GainOptimizationResult>(m, "GainOptimizationResult")
+        .def_readonly("best", &starSense::GainOptimizationResult::best)
+        .def_readonly("bestCost", &starSense::GainOptimizationResult::bestCost)
+        .def_readonly("initialCost", &starSense::GainOptimizationResult::initialCost)
+        .def_readonly("bestParams", &starSense::GainOptimizationResult::bestParams)
+        .def_readonly("generations", &starSense::GainOptimizationResult::generations)
+        .def_readonly("evaluations", &starSense::GainOptimizationResult::evaluations)
+        .def_readonly("costHistory", &starSense::GainOptimizationResult::costHistory)
+        .def_readonly("converged", &starSense::GainOptimizationResult::converged);
+
+    m.def("gain_cost", &starSense::gainCost, py::arg("cost"), py::arg("summary"), py::arg("params"),
+          "Cost of one run's summary under GainCost weights");
+    m.def(
+        "optimize_gains",
+        &starSense::optimizeGains,
+        py::arg("spec"),
+        py::call_guard<py::gil_scoped_release>(),
+        "Minimize a weighted summary cost over parameters with CMA-ES; each generation runs in parallel"
+    );
 }
@@ -0,0 +1,370 @@
+#include "optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "random.hpp"
+#include "sweep.hpp"
+
+namespace starSense {
+
+namespace {
+
+// Philox stream of the CMA-ES sampling normals (key: seed, 0)
+constexpr std::uint32_t kSampleStream = 0;
+
+// Row-major n x n matrix
+using Matrix = std::vector<double>;
+
+// Eigen-decomposition of a symmetric matrix by cyclic Jacobi rotations:
+// A = V diag(values) V^T, eigenvectors in the columns of V. The matrices
+// here are the optimizer's covariance (one row per variable), so the
+// O(n^3) sweeps are negligible next to a generation of simulations.
+void symmetricEigen(Matrix A, std::size_t n, std::vector<double> &values, Matrix &V) {
+    V.assign(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        V[i * n + i] = 1.0;
+    }
+
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0;
+        double diag = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            diag += A[i * n + i] * A[i * n + i];
+            for (std::size_t j = i + 1; j < n; ++j) {
+                off += A[i * n + j] * A[i * n + j];
+            }
+        }
+        if (off <= 1e-30 * diag) {
+            break;
+        }
+
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) {
+                const double apq = A[p * n + q];
+                if (apq == 0.0) {
+                    continue;
+                }
+                // Rotation that zeroes A[p][q]
+                const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+                const double t = std::copysign(1.0, theta) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double akp = A[k * n + p];
+                    const double akq = A[k * n + q];
+                    A[k * n + p] = c * akp - s * akq;
+                    A[k * n + q] = s * akp + c * akq;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double apk = A[p * n + k];
+                    const double aqk = A[q * n + k];
+                    A[p * n + k] = c * apk - s * aqk;
+                    A[q * n + k] = s * apk + c * aqk;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double vkp = V[k * n + p];
+                    const double vkq = V[k * n + q];
+                    V[k * n + p] = c * vkp - s * vkq;
+                    V[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    values.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        values[i] = A[i * n + i];
+    }
+}
+
+// Variable value at normalized coordinate u in [0, 1]
+double variableValue(const OptimizerVariable &v, double u) {
+    if (v.logScale) {
+        return std::exp(std::log(v.lo) + u * (std::log(v.hi) - std::log(v.lo)));
+    }
+    return v.lo + u * (v.hi - v.lo);
+}
+
+// Normalized coordinate of a variable value
+double variableCoordinate(const OptimizerVariable &v, double x) {
+    if (v.logScale) {
+        return (std::log(x) - std::log(v.lo)) / (std::log(v.hi) - std::log(v.lo));
+    }
+    return (x - v.lo) / (v.hi - v.lo);
+}
+
+AttitudeSimParams applyVariables(const AttitudeSimParams &base,
+                                 const std::vector<OptimizerVariable> &variables,
+                                 const std::vector<double> &values) {
+    AttitudeSimParams params = base;
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        const OptimizerVariable &v = variables[i];
+        setNumericParam(params, v.param, v.index, values[i], v.scale);
+    }
+    return params;
+}
+
+} // namespace
+
+double gainCost(const GainCost &cost, const SimulationSummary &summary, const AttitudeSimParams &params) {
+    double total = cost.rmsAttitudeError * summary.rmsAttitudeError
+                 + cost.peakAttitudeError * summary.peakAttitudeError
+                 + cost.finalAttitudeError * summary.finalAttitudeError
+                 + cost.controlImpulse * summary.controlImpulse
+                 + cost.saturationTime * summary.saturationTime;
+
+    if (cost.settlingTime != 0.0) {
+        const double settling = std::isnan(summary.settlingTime) ? 2.0 * summary.endTime : summary.settlingTime;
+        total += cost.settlingTime * settling;
+    }
+    if (cost.wheelSpeed != 0.0 && !params.maxWheelSpeed.empty()) {
+        const double limit = *std::min_element(params.maxWheelSpeed.begin(), params.maxWheelSpeed.end());
+        total += cost.wheelSpeed * summary.maxWheelSpeed / limit;
+    }
+    return total;
+}
+
+GainOptimizationResult optimizeGains(const GainOptimizationSpec &spec) {
+    const std::size_t n = spec.variables.size();
+    const std::size_t numCases = spec.cases.size();
+    if (numCases == 0) {
+        throw std::invalid_argument("optimizeGains: no evaluation cases");
+    }
+    if (n == 0) {
+        throw std::invalid_argument("optimizeGains: no variables");
+    }
+    if (!(spec.sigma0 > 0.0)) {
+        throw std::invalid_argument("optimizeGains: sigma0 must be > 0");
+    }
+
+    // Validate the variables and find the (normalized) starting point
+    std::vector<double> mean(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const OptimizerVariable &v = spec.variables[i];
+        const std::string where = "optimizeGains: variable '" + v.param + "'";
+        checkNumericParam(spec.cases.front(), v.param, v.index, "optimizeGains");
+        if (!(v.hi > v.lo) || (v.logScale && !(v.lo > 0.0))) {
+            throw std::invalid_argument(where + ": needs lo < hi (and lo > 0 with logScale)");
+        }
+        const double x0 = std::isnan(v.initial) ? variableValue(v, 0.5) : v.initial;
+        if (!(x0 >= v.lo && x0 <= v.hi)) {
+            throw std::invalid_argument(where + ": initial value outside [lo, hi]");
+        }
+        mean[i] = variableCoordinate(v, x0);
+    }
+
+    auto toValues = [&](const std::vector<double> &u) {
+        std::vector<double> x(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i] = variableValue(spec.variables[i], std::clamp(u[i], 0.0, 1.0));
+        }
+        return x;
+    };
+
+    // Mean cost over the cases of each candidate; every (candidate, case)
+    // pair is one task on the worker threads
+    GainOptimizationResult result;
+    auto evaluate = [&](const std::vector<std::vector<double>> &candidates, bool rethrow) {
+        std::vector<double> costs(candidates.size() * numCases);
+        parallelFor(costs.size(), spec.numThreads, [&](std::size_t task) {
+            const std::size_t k = task / numCases;
+            AttitudeSimParams params = applyVariables(spec.cases[task % numCases], spec.variables, candidates[k]);
+            params.summaryOnly = true;
+            try {
+                costs[task] = gainCost(spec.cost, runSimulation(params).summary, params);
+            } catch (...) {
+                // Any failing run makes the candidate infeasible
+                if (rethrow) {
+                    throw;
+                }
+                costs[task] = std::numeric_limits<double>::infinity();
+            }
+        });
+        result.evaluations += costs.size();
+
+        std::vector<double> out(candidates.size(), 0.0);
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            for (std::size_t c = 0; c < numCases; ++c) {
+                out[k] += costs[k * numCases + c];
+            }
+            out[k] /= static_cast<double>(numCases);
+            if (std::isnan(out[k])) {
+                out[k] = std::numeric_limits<double>::infinity();
+            }
+        }
+        return out;
+    };
+
+    result.best = toValues(mean);
+    result.initialCost = evaluate({result.best}, true).front();
+    result.bestCost = result.initialCost;
+
+    // Strategy parameters (Hansen's defaults)
+    const double dn = static_cast<double>(n);
+    std::size_t lambda = spec.populationSize;
+    if (lambda == 0) {
+        lambda = std::max<std::size_t>(
+            4 + static_cast<std::size_t>(3.0 * std::log(dn)),
+            resolveWorkerCount(spec.numThreads, std::numeric_limits<std::size_t>::max()));
+    }
+    lambda = std::max<std::size_t>(lambda, 2);
+    const std::size_t mu = lambda / 2;
+
+    std::vector<double> weights(mu);
+    for (std::size_t i = 0; i < mu; ++i) {
+        weights[i] = std::log(static_cast<double>(mu) + 0.5) - std::log(static_cast<double>(i) + 1.0);
+    }
+    const double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double weightSquares = 0.0;
+    for (double &w : weights) {
+        w /= weightSum;
+        weightSquares += w * w;
+    }
+    const double mueff = 1.0 / weightSquares;
+
+    const double cc = (4.0 + mueff / dn) / (dn + 4.0 + 2.0 * mueff / dn);
+    const double cs = (mueff + 2.0) / (dn + mueff + 5.0);
+    const double c1 = 2.0 / ((dn + 1.3) * (dn + 1.3) + mueff);
+    const double cmu = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((dn + 2.0) * (dn + 2.0) + mueff));
+    const double damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (dn + 1.0)) - 1.0) + cs;
+    const double chiN = std::sqrt(dn) * (1.0 - 1.0 / (4.0 * dn) + 1.0 / (21.0 * dn * dn));
+
+    // State: mean, step size, covariance C = B diag(D^2) B^T and the paths
+    double sigma = spec.sigma0;
+    Matrix C(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        C[i * n + i] = 1.0;
+    }
+    Matrix B;
+    std::vector<double> D(n, 1.0);
+    std::vector<double> pc(n, 0.0);
+    std::vector<double> ps(n, 0.0);
+
+    const PhiloxKey key = philoxKey(spec.seed, 0);
+    const std::size_t blocksPerSample = (n + 3) / 4;
+    std::uint64_t sampleIndex = 0;
+
+    std::vector<std::vector<double>> z(lambda, std::vector<double>(n));
+    std::vector<std::vector<double>> y(lambda, std::vector<double>(n));
+    std::vector<std::vector<double>> u(lambda, std::vector<double>(n));
+    std::vector<std::vector<double>> candidates(lambda);
+    std::vector<std::size_t> order(lambda);
+
+    for (std::size_t gen = 0; gen < spec.maxGenerations; ++gen) {
+        std::vector<double> eigenvalues;
+        symmetricEigen(C, n, eigenvalues, B);
+        for (std::size_t i = 0; i < n; ++i) {
+            D[i] = std::sqrt(std::max(eigenvalues[i], 1e-300));
+        }
+
+        // Sample: y_k = B D z_k, u_k = mean + sigma y_k
+        for (std::size_t k = 0; k < lambda; ++k, ++sampleIndex) {
+            for (std::size_t b = 0; b < blocksPerSample; ++b) {
+                const std::array<double, 4> normals =
+                    philoxNormals(key, sampleIndex * blocksPerSample + b, kSampleStream);
+                for (std::size_t j = 0; j < 4 && 4 * b + j < n; ++j) {
+                    z[k][4 * b + j] = normals[j];
+                }
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                double yi = 0.0;
+                for (std::size_t j = 0; j < n; ++j) {
+                    yi += B[i * n + j] * D[j] * z[k][j];
+                }
+                y[k][i] = yi;
+                u[k][i] = mean[i] + sigma * yi;
+            }
+            candidates[k] = toValues(u[k]);
+        }
+
+        // Candidates outside the box run at the nearest point inside it, plus
+        // a penalty growing with the distance
+        std::vector<double> fitness = evaluate(candidates, false);
+        for (std::size_t k = 0; k < lambda; ++k) {
+            double outside = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const double d = u[k][i] - std::clamp(u[k][i], 0.0, 1.0);
+                outside += d * d;
+            }
+            if (fitness[k] < result.bestCost) {
+                result.bestCost = fitness[k];
+                result.best = candidates[k];
+            }
+            fitness[k] += outside * (1.0 + std::abs(fitness[k]));
+        }
+        result.costHistory.push_back(result.bestCost);
+        result.generations = gen + 1;
+
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(),
+            [&fitness](std::size_t a, std::size_t b) { return fitness[a] < fitness[b]; });
+
+        // Recombination: weighted mean of the mu best steps
+        std::vector<double> yw(n, 0.0);
+        std::vector<double> zw(n, 0.0);
+        for (std::size_t r = 0; r < mu; ++r) {
+            for (std::size_t i = 0; i < n; ++i) {
+                yw[i] += weights[r] * y[order[r]][i];
+                zw[i] += weights[r] * z[order[r]][i];
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            mean[i] += sigma * yw[i];
+        }
+
+        // Step-size path: ps uses C^{-1/2} yw = B zw
+        const double csNorm = std::sqrt(cs * (2.0 - cs) * mueff);
+        double psNorm = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double bz = 0.0;
+            for (std::size_t j = 0; j < n; ++j) {
+                bz += B[i * n + j] * zw[j];
+            }
+            ps[i] = (1.0 - cs) * ps[i] + csNorm * bz;
+            psNorm += ps[i] * ps[i];
+        }
+        psNorm = std::sqrt(psNorm);
+
+        const double psDecay = 1.0 - std::pow(1.0 - cs, 2.0 * static_cast<double>(gen + 1));
+        const bool hsig = psNorm / std::sqrt(psDecay) / chiN < 1.4 + 2.0 / (dn + 1.0);
+
+        const double ccNorm = std::sqrt(cc * (2.0 - cc) * mueff);
+        for (std::size_t i = 0; i < n; ++i) {
+            pc[i] = (1.0 - cc) * pc[i] + (hsig ? ccNorm * yw[i] : 0.0);
+        }
+
+        // Covariance: rank-one (evolution path) plus rank-mu update
+        const double oldWeight = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j <= i; ++j) {
+                double rankMu = 0.0;
+                for (std::size_t r = 0; r < mu; ++r) {
+                    rankMu += weights[r] * y[order[r]][i] * y[order[r]][j];
+                }
+                const double cij = oldWeight * C[i * n + j] + c1 * pc[i] * pc[j] + cmu * rankMu;
+                C[i * n + j] = cij;
+                C[j * n + i] = cij;
+            }
+        }
+
+        sigma *= std::exp((cs / damps) * (psNorm / chiN - 1.0));
+
+        double maxStd = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            maxStd = std::max(maxStd, std::sqrt(C[i * n + i]));
+        }
+        if (sigma * maxStd < spec.xTolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    result.bestParams = applyVariables(spec.cases.front(), spec.variables, result.best);
+    return result;
+}
+
+} // namespace starSense
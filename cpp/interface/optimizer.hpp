@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Closed-loop gain optimization
+//
+// Derivative-free search over numeric AttitudeSimParams fields (gains, LQR
+// weights, rates) with CMA-ES (Hansen, "The CMA Evolution Strategy: A
+// Tutorial", 2016). Every generation samples a population of candidates,
+// and all of them (times every evaluation case) run in parallel on the
+// worker threads, so a generation costs about one simulation per core.
+// Runs keep only their summary; the cost is a weighted sum of its metrics.
+// ----------------------------------------------------------
+
+// One decision variable: a numeric parameter component within [lo, hi]
+struct OptimizerVariable {
+    std::string param;   // AttitudeSimParams field name (see forEachParam)
+    int index = -1;      // component, row-major (-1: every component)
+    double lo = 0.0;
+    double hi = 1.0;
+    double initial = std::numeric_limits<double>::quiet_NaN();  // start (NaN: middle of the range)
+    bool logScale = false;  // search log(value) (lo > 0), for gains spanning decades
+    bool scale = false;     // the value multiplies the case's parameter instead of replacing it
+};
+
+// Cost of one run: sum of weight * metric over SimulationSummary
+struct GainCost {
+    double settlingTime = 0.0;       // [1/s]; unsettled runs count as 2 * endTime
+    double rmsAttitudeError = 1.0;   // [1/rad]
+    double peakAttitudeError = 0.0;  // [1/rad]
+    double finalAttitudeError = 0.0; // [1/rad]
+    double controlImpulse = 0.0;     // [1/(N·m·s)]
+    double saturationTime = 0.0;     // [1/s], torque saturation
+    double wheelSpeed = 0.0;         // on max wheel speed as a fraction of the smallest maxWheelSpeed
+};
+
+struct GainOptimizationSpec {
+    // Evaluation cases (initial conditions, dispersions): a candidate's cost
+    // is the mean over them
+    std::vector<AttitudeSimParams> cases;
+    std::vector<OptimizerVariable> variables;
+    GainCost cost;
+
+    std::size_t populationSize = 0;   // 0: max(4 + 3 ln n, worker count)
+    std::size_t maxGenerations = 100;
+    double sigma0 = 0.3;              // initial step, as a fraction of each variable's range
+    double xTolerance = 1e-4;         // stop when the step falls below this fraction of the ranges
+    std::uint32_t seed = 0;
+    int numThreads = 0;               // worker count (<= 0 uses one per hardware thread)
+};
+
+struct GainOptimizationResult {
+    std::vector<double> best;           // one value per variable
+    double bestCost = 0.0;
+    double initialCost = 0.0;           // cost at the starting point
+    AttitudeSimParams bestParams;       // the first case with `best` applied
+    std::size_t generations = 0;
+    std::size_t evaluations = 0;        // simulations run
+    std::vector<double> costHistory;    // best cost so far, per generation
+    bool converged = false;             // xTolerance reached before maxGenerations
+};
+
+// Cost of one run's summary (params supplies the wheel speed limits)
+double gainCost(const GainCost &cost, const SimulationSummary &summary, const AttitudeSimParams &params);
+
+// Minimize spec.cost over spec.variables. Throws std::invalid_argument for
+// an empty case list, bad variables or ranges; an exception from the runs at
+// the starting point is rethrown, while a failing candidate later on (for
+// example an LQR synthesis that does not converge) just costs +inf.
+GainOptimizationResult optimizeGains(const GainOptimizationSpec &spec);
+
+} // namespace starSense
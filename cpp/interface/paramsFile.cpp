@@ -0,0 +1,358 @@
+#include "paramsFile.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "paramsJson.hpp"
+
+namespace starSense {
+
+namespace {
+
+// Cursor over config text. Values use the JSON grammar in both formats;
+// TOML mode additionally skips # comments.
+class ConfigReader {
+public:
+    ConfigReader(const std::string &text, const std::string &source, bool toml)
+        : text_(text), source_(source), toml_(toml) { }
+
+    void skipSpace() {
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                ++pos_;
+            } else if (toml_ && c == '#') {
+                while (pos_ < text_.size() && text_[pos_] != '\n') {
+                    ++pos_;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return pos_ >= text_.size();
+    }
+
+    char peek() {
+        skipSpace();
+        return (pos_ < text_.size()) ? text_[pos_] : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+
+    std::string readString() {
+        expect('"');
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\' && pos_ < text_.size()) {
+                const char e = text_[pos_++];
+                switch (e) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case '"': case '\\': case '/': c = e; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u':
+                    appendUtf8(out, readHex4());
+                    continue;
+                default: fail(std::string("unsupported escape '\\") + e + "'");
+                }
+            }
+            out += c;
+        }
+        expect('"');
+        return out;
+    }
+
+    // The four hex digits of a \u escape
+    unsigned readHex4() {
+        if (text_.size() - pos_ < 4) {
+            fail("truncated \\u escape");
+        }
+        unsigned code = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char h = text_[pos_++];
+            code <<= 4;
+            if (h >= '0' && h <= '9') {
+                code |= static_cast<unsigned>(h - '0');
+            } else if (h >= 'a' && h <= 'f') {
+                code |= static_cast<unsigned>(h - 'a' + 10);
+            } else if (h >= 'A' && h <= 'F') {
+                code |= static_cast<unsigned>(h - 'A' + 10);
+            } else {
+                fail("bad hex digit in \\u escape");
+            }
+        }
+        if (code >= 0xD800 && code <= 0xDFFF) {
+            fail("unsupported surrogate in \\u escape");
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string &out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    // TOML key: bare (letters, digits, _ and -) or quoted
+    std::string readKey() {
+        if (peek() == '"') {
+            return readString();
+        }
+        const std::size_t start = pos_;
+        while (pos_ < text_.size() &&
+               (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+                text_[pos_] == '_' || text_[pos_] == '-')) {
+            ++pos_;
+        }
+        if (pos_ == start) {
+            fail("expected a key");
+        }
+        return text_.substr(start, pos_ - start);
+    }
+
+    double readNumber() {
+        skipSpace();
+        const char *begin = text_.c_str() + pos_;
+        char *end = nullptr;
+        errno = 0;
+        const double v = std::strtod(begin, &end);
+        if (end == begin || errno == ERANGE) {
+            fail("expected a number");
+        }
+        pos_ += static_cast<std::size_t>(end - begin);
+        return v;
+    }
+
+    bool consumeNull() {
+        skipSpace();
+        if (text_.compare(pos_, 4, "null") == 0) {
+            pos_ += 4;
+            return true;
+        }
+        return false;
+    }
+
+    bool readBool() {
+        skipSpace();
+        if (text_.compare(pos_, 4, "true") == 0) {
+            pos_ += 4;
+            return true;
+        }
+        if (text_.compare(pos_, 5, "false") == 0) {
+            pos_ += 5;
+            return false;
+        }
+        fail("expected true or false");
+    }
+
+    [[noreturn]] void fail(const std::string &what) const {
+        std::size_t line = 1;
+        for (std::size_t i = 0; i < pos_ && i < text_.size(); ++i) {
+            line += (text_[i] == '\n') ? 1 : 0;
+        }
+        std::ostringstream oss;
+        oss << source_ << ":" << line << ": " << what;
+        throw std::invalid_argument(oss.str());
+    }
+
+private:
+    const std::string &text_;
+    std::string source_;
+    bool toml_;
+    std::size_t pos_ = 0;
+};
+
+// null stands for a non-finite value (see paramsToJson) and reads as +infinity
+void readValue(ConfigReader &in, double &v) {
+    v = in.consumeNull() ? std::numeric_limits<double>::infinity() : in.readNumber();
+}
+
+void readValue(ConfigReader &in, int &v) {
+    const double d = in.readNumber();
+    if (d != std::floor(d) || std::abs(d) > 2147483647.0) {
+        in.fail("expected an integer");
+    }
+    v = static_cast<int>(d);
+}
+
+void readValue(ConfigReader &in, bool &v) {
+    v = in.readBool();
+}
+
+void readValue(ConfigReader &in, std::string &v) {
+    v = in.readString();
+}
+
+// Declared up front so nested arrays (Mat3, std::vector<Vec3>) resolve
+template <typename T, std::size_t N>
+void readValue(ConfigReader &in, std::array<T, N> &values);
+
+template <typename T>
+void readValue(ConfigReader &in, std::vector<T> &values);
+
+// '[' v (',' v)* ','? ']', calling readElement(index) for each value
+template <typename ReadElement>
+std::size_t readArray(ConfigReader &in, ReadElement &&readElement) {
+    in.expect('[');
+    std::size_t count = 0;
+    while (!in.consume(']')) {
+        readElement(count++);
+        if (!in.consume(',')) {
+            in.expect(']');
+            break;
+        }
+    }
+    return count;
+}
+
+template <typename T, std::size_t N>
+void readValue(ConfigReader &in, std::array<T, N> &values) {
+    const std::size_t count = readArray(in, [&](std::size_t i) {
+        if (i >= N) {
+            in.fail("expected " + std::to_string(N) + " elements");
+        }
+        readValue(in, values[i]);
+    });
+    if (count != N) {
+        in.fail("expected " + std::to_string(N) + " elements, got " + std::to_string(count));
+    }
+}
+
+template <typename T>
+void readValue(ConfigReader &in, std::vector<T> &values) {
+    values.clear();
+    readArray(in, [&](std::size_t) {
+        values.emplace_back();
+        readValue(in, values.back());
+    });
+}
+
+// Parse the value for `key` straight into the matching params field
+void readParam(ConfigReader &in, AttitudeSimParams &params, const std::string &key) {
+    bool found = false;
+    forEachParam(params, [&](const char *name, auto &field) {
+        if (!found && key == name) {
+            readValue(in, field);
+            found = true;
+        }
+    });
+    if (!found) {
+        in.fail("unknown parameter '" + key + "'");
+    }
+}
+
+AttitudeSimParams readJsonObject(ConfigReader &in) {
+    AttitudeSimParams params;
+    in.expect('{');
+    while (!in.consume('}')) {
+        const std::string key = in.readString();
+        in.expect(':');
+        readParam(in, params, key);
+        if (!in.consume(',')) {
+            in.expect('}');
+            break;
+        }
+    }
+    return params;
+}
+
+} // namespace
+
+std::vector<AttitudeSimParams> paramsListFromJson(const std::string &text, const std::string &source) {
+    ConfigReader in(text, source, false);
+    std::vector<AttitudeSimParams> cases;
+
+    if (in.peek() == '[') {
+        readArray(in, [&](std::size_t) { cases.push_back(readJsonObject(in)); });
+        if (!in.atEnd()) {
+            in.fail("unexpected text after the case array");
+        }
+    } else {
+        // One object, or several back to back (JSON Lines)
+        while (!in.atEnd()) {
+            cases.push_back(readJsonObject(in));
+        }
+    }
+
+    if (cases.empty()) {
+        in.fail("no cases found");
+    }
+    return cases;
+}
+
+std::vector<AttitudeSimParams> paramsListFromToml(const std::string &text, const std::string &source) {
+    ConfigReader in(text, source, true);
+    AttitudeSimParams base;
+    std::vector<AttitudeSimParams> cases;
+    AttitudeSimParams *current = &base;
+
+    while (!in.atEnd()) {
+        if (in.consume('[')) {
+            in.expect('[');
+            const std::string table = in.readKey();
+            if (table != "cases") {
+                in.fail("unsupported table [[" + table + "]] (only [[cases]])");
+            }
+            in.expect(']');
+            in.expect(']');
+            cases.push_back(base);
+            current = &cases.back();
+            continue;
+        }
+
+        const std::string key = in.readKey();
+        in.expect('=');
+        readParam(in, *current, key);
+    }
+
+    if (cases.empty()) {
+        cases.push_back(base);
+    }
+    return cases;
+}
+
+std::vector<AttitudeSimParams> loadParamsFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::invalid_argument("loadParamsFile: cannot open '" + path + "'");
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+
+    const bool toml = path.size() >= 5 && path.compare(path.size() - 5, 5, ".toml") == 0;
+    return toml ? paramsListFromToml(buffer.str(), path) : paramsListFromJson(buffer.str(), path);
+}
+
+} // namespace starSense
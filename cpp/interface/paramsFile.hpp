@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Reading AttitudeSimParams from config files
+//
+// Keys are the AttitudeSimParams field names (see forEachParam); unset
+// fields keep their defaults, unknown keys are an error. A numeric null
+// reads as +infinity (paramsToJson writes non-finite values as null).
+//
+// JSON (.json, .jsonl)
+//   {"dt": 0.01, "q0": [1, 0, 0, 0], ...}         one case
+//   [{...}, {...}]                                 many cases
+//   {...}\n{...}\n                                 many cases (JSON Lines)
+//
+// TOML subset (.toml): `key = value` with JSON-style values (numbers,
+// "strings", true/false, [arrays], possibly spanning lines) and # comments.
+// Keys before the first [[cases]] header are shared defaults; each
+// [[cases]] table starts from them and adds its own overrides.
+//
+//   dt = 0.01
+//   controllerType = "pd"
+//   [[cases]]
+//   w0 = [0.1, 0.0, 0.0]
+//   [[cases]]
+//   w0 = [0.0, 0.1, 0.0]
+//
+// Errors throw std::invalid_argument with the source name and line.
+// ----------------------------------------------------------
+
+std::vector<AttitudeSimParams> paramsListFromJson(const std::string &text,
+                                                  const std::string &source = "<json>");
+
+std::vector<AttitudeSimParams> paramsListFromToml(const std::string &text,
+                                                  const std::string &source = "<toml>");
+
+// Read a config file, choosing the format from its extension (.toml is
+// TOML, anything else is JSON)
+std::vector<AttitudeSimParams> loadParamsFile(const std::string &path);
+
+} // namespace starSense
@@ -0,0 +1,101 @@
+#include "paramsJson.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace starSense {
+
+namespace {
+
+// JSON has no inf / nan: non-finite values are written as null (which the
+// config reader takes as +infinity, e.g. an unlimited wheel speed)
+void writeJson(std::string &out, double v) {
+    if (!std::isfinite(v)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    out += buf;
+}
+
+void writeJson(std::string &out, int v) {
+    out += std::to_string(v);
+}
+
+void writeJson(std::string &out, bool v) {
+    out += v ? "true" : "false";
+}
+
+void writeJson(std::string &out, const std::string &s) {
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\t': out += "\\t";  break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+            break;
+        }
+    }
+    out += '"';
+}
+
+// Declared up front so nested arrays (Mat3, std::vector<Vec3>) resolve
+template <typename T, std::size_t N>
+void writeJson(std::string &out, const std::array<T, N> &values);
+
+template <typename T>
+void writeJson(std::string &out, const std::vector<T> &values);
+
+template <typename Seq>
+void writeJsonArray(std::string &out, const Seq &values) {
+    out += '[';
+    bool first = true;
+    for (const auto &v : values) {
+        if (!first) {
+            out += ", ";
+        }
+        first = false;
+        writeJson(out, v);
+    }
+    out += ']';
+}
+
+template <typename T, std::size_t N>
+void writeJson(std::string &out, const std::array<T, N> &values) {
+    writeJsonArray(out, values);
+}
+
+template <typename T>
+void writeJson(std::string &out, const std::vector<T> &values) {
+    writeJsonArray(out, values);
+}
+
+} // namespace
+
+std::string paramsToJson(const AttitudeSimParams &params) {
+    std::string out = "{";
+    bool first = true;
+    forEachParam(params, [&](const char *name, const auto &value) {
+        if (!first) {
+            out += ", ";
+        }
+        first = false;
+        writeJson(out, std::string(name));
+        out += ": ";
+        writeJson(out, value);
+    });
+    out += '}';
+    return out;
+}
+
+} // namespace starSense
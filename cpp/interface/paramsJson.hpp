@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+
+#include "api.hpp"
+
+namespace starSense {
+
+// Visit every AttitudeSimParams field as fn(name, field).
+// The JSON writer (and reader) go through this list, so a new parameter
+// only needs to be added here to be serialized.
+template <typename Params, typename Fn>
+void forEachParam(Params &p, Fn &&fn) {
+    fn("q0", p.q0);
+    fn("w0", p.w0);
+    fn("inertiaBody", p.inertiaBody);
+    fn("dt", p.dt);
+    fn("numSteps", p.numSteps);
+    fn("logEvery", p.logEvery);
+    fn("logChunkSize", p.logChunkSize);
+    fn("derivedChannels", p.derivedChannels);
+    fn("trajectoryPath", p.trajectoryPath);
+    fn("trajectoryFloat32", p.trajectoryFloat32);
+    fn("summaryMetrics", p.summaryMetrics);
+    fn("summaryOnly", p.summaryOnly);
+    fn("settlingAttitudeError", p.settlingAttitudeError);
+    fn("settlingRateError", p.settlingRateError);
+    fn("rmsStartTime", p.rmsStartTime);
+    fn("eventAttitudeError", p.eventAttitudeError);
+    fn("eventRateError", p.eventRateError);
+    fn("eventWheelSpeedLimit", p.eventWheelSpeedLimit);
+    fn("stopOnEvent", p.stopOnEvent);
+    fn("integratorType", p.integratorType);
+    fn("absTol", p.absTol);
+    fn("relTol", p.relTol);
+    fn("controllerType", p.controllerType);
+    fn("kpAtt", p.kpAtt);
+    fn("kdRate", p.kdRate);
+    fn("kLqr", p.kLqr);
+    fn("controlRateHz", p.controlRateHz);
+    fn("lqrAttWeights", p.lqrAttWeights);
+    fn("lqrRateWeights", p.lqrRateWeights);
+    fn("lqrTorqueWeights", p.lqrTorqueWeights);
+    fn("sensorType", p.sensorType);
+    fn("sensorRateHz", p.sensorRateHz);
+    fn("noiseSeed", p.noiseSeed);
+    fn("caseId", p.caseId);
+    fn("starTrackerNoise", p.starTrackerNoise);
+    fn("starTrackerBias", p.starTrackerBias);
+    fn("gyroNoise", p.gyroNoise);
+    fn("gyroBias0", p.gyroBias0);
+    fn("gyroBiasRandomWalk", p.gyroBiasRandomWalk);
+    fn("estimatorType", p.estimatorType);
+    fn("mekfInitialAttSigma", p.mekfInitialAttSigma);
+    fn("mekfInitialBiasSigma", p.mekfInitialBiasSigma);
+    fn("actuatorType", p.actuatorType);
+    fn("actuatorRateHz", p.actuatorRateHz);
+    fn("wheelAxes", p.wheelAxes);
+    fn("wheelInertias", p.wheelInertias);
+    fn("maxWheelTorque", p.maxWheelTorque);
+    fn("maxWheelSpeed", p.maxWheelSpeed);
+    fn("wheelSpeeds0", p.wheelSpeeds0);
+    fn("nullSpaceGain", p.nullSpaceGain);
+    fn("wheelSpeedsTarget", p.wheelSpeedsTarget);
+    fn("gravityGradient", p.gravityGradient);
+    fn("aeroDrag", p.aeroDrag);
+    fn("solarPressure", p.solarPressure);
+    fn("magneticDipole", p.magneticDipole);
+    fn("environmentUpdateInterval", p.environmentUpdateInterval);
+    fn("orbitSemiMajorAxis", p.orbitSemiMajorAxis);
+    fn("orbitEccentricity", p.orbitEccentricity);
+    fn("orbitInclination", p.orbitInclination);
+    fn("orbitRaan", p.orbitRaan);
+    fn("orbitArgPerigee", p.orbitArgPerigee);
+    fn("orbitMeanAnomaly", p.orbitMeanAnomaly);
+    fn("orbitJ2", p.orbitJ2);
+    fn("sunLongitude0", p.sunLongitude0);
+    fn("dragArea", p.dragArea);
+    fn("dragCoefficient", p.dragCoefficient);
+    fn("srpArea", p.srpArea);
+    fn("srpReflectivity", p.srpReflectivity);
+    fn("centerOfPressure", p.centerOfPressure);
+    fn("residualDipole", p.residualDipole);
+    fn("referenceType", p.referenceType);
+    fn("qRef", p.qRef);
+    fn("wRef", p.wRef);
+}
+
+// Serialize params as a single-line JSON object (finite doubles round-trip
+// exactly; non-finite ones are written as null, which reads back as +inf)
+std::string paramsToJson(const AttitudeSimParams &params);
+
+} // namespace starSense
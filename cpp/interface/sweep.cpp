@@ -0,0 +1,370 @@
+#include "sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "paramsJson.hpp"
+#include "random.hpp"
+
+namespace starSense {
+
+namespace {
+
+// Philox streams of the sampled axes (key: seed, axis)
+constexpr std::uint32_t kLhsPermutationStream = 0;
+constexpr std::uint32_t kLhsJitterStream = 1;
+constexpr std::uint32_t kUniformStream = 2;
+constexpr std::uint32_t kNormalStream = 3;
+
+// Sobol primitive polynomials and initial direction numbers for dimensions
+// 2..16 (Joe & Kuo, new-joe-kuo-6.21201); dimension 1 is the van der Corput
+// sequence
+struct SobolPolynomial {
+    unsigned degree;
+    std::uint32_t coefficients;
+    std::uint32_t m[6];
+};
+
+constexpr SobolPolynomial kSobolPolynomials[] = {
+    {1, 0,  {1}},
+    {2, 1,  {1, 3}},
+    {3, 1,  {1, 3, 1}},
+    {3, 2,  {1, 1, 1}},
+    {4, 1,  {1, 1, 3, 3}},
+    {4, 4,  {1, 3, 5, 13}},
+    {5, 2,  {1, 1, 5, 5, 17}},
+    {5, 4,  {1, 1, 5, 5, 5}},
+    {5, 7,  {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1,  {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+};
+
+constexpr std::size_t kMaxSobolDims = 1 + sizeof(kSobolPolynomials) / sizeof(kSobolPolynomials[0]);
+
+// Direction numbers v_k (scaled by 2^32) of Sobol dimension `dim` (0-based)
+std::array<std::uint32_t, 32> sobolDirections(std::size_t dim) {
+    std::array<std::uint32_t, 32> v{};
+    if (dim == 0) {
+        for (unsigned k = 0; k < 32; ++k) {
+            v[k] = 1u << (31 - k);
+        }
+        return v;
+    }
+    const SobolPolynomial &p = kSobolPolynomials[dim - 1];
+    const unsigned s = p.degree;
+    for (unsigned k = 0; k < s; ++k) {
+        v[k] = p.m[k] << (31 - k);
+    }
+    for (unsigned k = s; k < 32; ++k) {
+        v[k] = v[k - s] ^ (v[k - s] >> s);
+        for (unsigned j = 1; j < s; ++j) {
+            if ((p.coefficients >> (s - 1 - j)) & 1u) {
+                v[k] ^= v[k - j];
+            }
+        }
+    }
+    return v;
+}
+
+// Point `index` of one Sobol dimension, in [0, 1)
+double sobolPoint(const std::array<std::uint32_t, 32> &v, std::size_t index) {
+    std::uint32_t x = 0;
+    for (unsigned k = 0; k < 32 && index != 0; ++k, index >>= 1) {
+        if (index & 1u) {
+            x ^= v[k];
+        }
+    }
+    return static_cast<double>(x) * (1.0 / 4294967296.0);
+}
+
+// Summary of a case that did not run: every metric NaN
+SimulationSummary failedSummary() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    SimulationSummary s;
+    s.endTime = nan;
+    s.settlingTime = nan;
+    s.peakAttitudeError = nan;
+    s.peakAttitudeErrorTime = nan;
+    s.peakRateError = nan;
+    s.rmsAttitudeError = nan;
+    s.finalAttitudeError = nan;
+    s.finalRateError = nan;
+    s.controlImpulse = nan;
+    s.saturationTime = nan;
+    s.maxWheelSpeed = nan;
+    return s;
+}
+
+// Visit every numeric element of a parameter field in row-major order as
+// fn(element); bool and string fields have none
+template <typename Fn>
+void forEachNumber(double &v, Fn &&fn) { fn(v); }
+
+template <typename Fn>
+void forEachNumber(int &v, Fn &&fn) { fn(v); }
+
+template <typename Fn>
+void forEachNumber(bool &, Fn &&) { }
+
+template <typename Fn>
+void forEachNumber(std::string &, Fn &&) { }
+
+// Declared up front so nested containers (Mat3, std::vector<Vec3>) resolve
+template <typename T, std::size_t N, typename Fn>
+void forEachNumber(std::array<T, N> &values, Fn &&fn);
+
+template <typename T, typename Fn>
+void forEachNumber(std::vector<T> &values, Fn &&fn);
+
+template <typename T, std::size_t N, typename Fn>
+void forEachNumber(std::array<T, N> &values, Fn &&fn) {
+    for (T &v : values) {
+        forEachNumber(v, fn);
+    }
+}
+
+template <typename T, typename Fn>
+void forEachNumber(std::vector<T> &values, Fn &&fn) {
+    for (T &v : values) {
+        forEachNumber(v, fn);
+    }
+}
+
+} // namespace
+
+// ----------------------------------------------------------
+// Numeric parameters by name
+// ----------------------------------------------------------
+
+std::size_t numericParamSize(const AttitudeSimParams &params, const std::string &param) {
+    AttitudeSimParams copy = params;
+    long count = -1;
+    forEachParam(copy, [&](const char *fieldName, auto &field) {
+        if (param != fieldName) {
+            return;
+        }
+        count = 0;
+        forEachNumber(field, [&count](auto &) { ++count; });
+    });
+    if (count < 0) {
+        throw std::invalid_argument("unknown parameter '" + param + "'");
+    }
+    if (count == 0) {
+        throw std::invalid_argument("'" + param + "' is not a numeric parameter (or is empty)");
+    }
+    return static_cast<std::size_t>(count);
+}
+
+std::size_t checkNumericParam(const AttitudeSimParams &params, const std::string &param, int index,
+                              const std::string &where) {
+    std::size_t elements = 0;
+    try {
+        elements = numericParamSize(params, param);
+    } catch (const std::invalid_argument &e) {
+        throw std::invalid_argument(where + ": " + e.what());
+    }
+    if (index < -1 || index >= static_cast<long>(elements)) {
+        throw std::invalid_argument(
+            where + ": '" + param + "' index " + std::to_string(index) + " out of range (" +
+            std::to_string(elements) + " components; -1 selects all)");
+    }
+    return elements;
+}
+
+void setNumericParam(AttitudeSimParams &params, const std::string &param, int index, double value, bool scale) {
+    forEachParam(params, [&](const char *fieldName, auto &field) {
+        if (param != fieldName) {
+            return;
+        }
+        long k = 0;
+        forEachNumber(field, [&](auto &element) {
+            if (index < 0 || k == index) {
+                const double x = scale ? static_cast<double>(element) * value : value;
+                if constexpr (std::is_same_v<std::decay_t<decltype(element)>, int>) {
+                    element = static_cast<int>(std::lround(x));
+                } else {
+                    element = x;
+                }
+            }
+            ++k;
+        });
+    });
+}
+
+bool isTaskRateParam(const std::string &param) {
+    return param == "controlRateHz" || param == "sensorRateHz" || param == "actuatorRateHz";
+}
+
+// ----------------------------------------------------------
+// ParameterSweep
+// ----------------------------------------------------------
+
+ParameterSweep::ParameterSweep(SweepSpec spec)
+    : spec_(std::move(spec))
+{
+    const std::size_t numAxes = spec_.axes.size();
+    kinds_.resize(numAxes);
+    sobolDirections_.resize(numAxes);
+    lhsStrata_.resize(numAxes);
+
+    bool sampled = false;
+    std::size_t sobolDims = 0;
+    for (std::size_t a = 0; a < numAxes; ++a) {
+        const SweepAxis &axis = spec_.axes[a];
+        const std::string where = "ParameterSweep: axis '" + axis.param + "'";
+        checkNumericParam(spec_.base, axis.param, axis.index, "ParameterSweep");
+
+        if (axis.kind == "grid") {
+            kinds_[a] = Kind::Grid;
+            if (axis.values.empty()) {
+                throw std::invalid_argument(where + ": grid axis has no values");
+            }
+            gridSize_ *= axis.values.size();
+            continue;
+        }
+
+        if (isTaskRateParam(axis.param)) {
+            throw std::invalid_argument(
+                where + ": task rates must be whole numbers of dt steps per period; use a grid axis");
+        }
+
+        if (axis.kind == "lhs") {
+            kinds_[a] = Kind::LatinHypercube;
+        } else if (axis.kind == "sobol") {
+            kinds_[a] = Kind::Sobol;
+            if (sobolDims == kMaxSobolDims) {
+                throw std::invalid_argument(where + ": at most " + std::to_string(kMaxSobolDims) + " sobol axes");
+            }
+            sobolDirections_[a] = sobolDirections(sobolDims++);
+        } else if (axis.kind == "uniform") {
+            kinds_[a] = Kind::Uniform;
+        } else if (axis.kind == "normal") {
+            kinds_[a] = Kind::Normal;
+        } else {
+            throw std::invalid_argument(where + ": unknown kind '" + axis.kind + "'");
+        }
+        sampled = true;
+    }
+
+    if (sampled) {
+        if (spec_.samples == 0) {
+            throw std::invalid_argument("ParameterSweep: samples must be >= 1 with sampled axes");
+        }
+        samplesPerPoint_ = spec_.samples;
+    }
+
+    // Latin hypercube: a random stratum per sample (Fisher-Yates), one
+    // permutation per axis so the axes are paired at random
+    for (std::size_t a = 0; a < numAxes; ++a) {
+        if (kinds_[a] != Kind::LatinHypercube) {
+            continue;
+        }
+        std::vector<std::uint32_t> &strata = lhsStrata_[a];
+        strata.resize(samplesPerPoint_);
+        for (std::size_t j = 0; j < samplesPerPoint_; ++j) {
+            strata[j] = static_cast<std::uint32_t>(j);
+        }
+        const PhiloxKey key = philoxKey(spec_.seed, static_cast<std::uint32_t>(a));
+        for (std::size_t j = samplesPerPoint_; j > 1; --j) {
+            const PhiloxCounter bits = philox4x32(philoxCounter(j, kLhsPermutationStream), key);
+            const std::size_t k = static_cast<std::size_t>(uniformOpen01(bits[0]) * static_cast<double>(j));
+            std::swap(strata[j - 1], strata[std::min(k, j - 1)]);
+        }
+    }
+}
+
+double ParameterSweep::sampledValue_(std::size_t axis, std::size_t sample) const {
+    const SweepAxis &a = spec_.axes[axis];
+    const PhiloxKey key = philoxKey(spec_.seed, static_cast<std::uint32_t>(axis));
+
+    switch (kinds_[axis]) {
+    case Kind::LatinHypercube: {
+        const PhiloxCounter bits = philox4x32(philoxCounter(sample, kLhsJitterStream), key);
+        const double u = (static_cast<double>(lhsStrata_[axis][sample]) + uniformOpen01(bits[0])) /
+                         static_cast<double>(samplesPerPoint_);
+        return a.lo + u * (a.hi - a.lo);
+    }
+    case Kind::Sobol:
+        return a.lo + sobolPoint(sobolDirections_[axis], sample) * (a.hi - a.lo);
+    case Kind::Uniform: {
+        const PhiloxCounter bits = philox4x32(philoxCounter(sample, kUniformStream), key);
+        return a.lo + uniformOpen01(bits[0]) * (a.hi - a.lo);
+    }
+    case Kind::Normal:
+        return a.lo + a.hi * philoxNormals(key, sample, kNormalStream)[0];
+    case Kind::Grid:
+        break;
+    }
+    return 0.0;
+}
+
+std::vector<double> ParameterSweep::coordinates(std::size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("ParameterSweep: case index out of range");
+    }
+    const std::size_t sample = i % samplesPerPoint_;
+    std::size_t gridIndex = i / samplesPerPoint_;
+
+    // Grid axes are nested loops in axis order: the last one varies fastest
+    std::vector<double> out(spec_.axes.size());
+    for (std::size_t a = spec_.axes.size(); a-- > 0;) {
+        if (kinds_[a] == Kind::Grid) {
+            const std::vector<double> &values = spec_.axes[a].values;
+            out[a] = values[gridIndex % values.size()];
+            gridIndex /= values.size();
+        } else {
+            out[a] = sampledValue_(a, sample);
+        }
+    }
+    return out;
+}
+
+AttitudeSimParams ParameterSweep::params(std::size_t i) const {
+    const std::vector<double> coords = coordinates(i);
+    AttitudeSimParams params = spec_.base;
+    for (std::size_t a = 0; a < coords.size(); ++a) {
+        const SweepAxis &axis = spec_.axes[a];
+        setNumericParam(params, axis.param, axis.index, coords[a], axis.scale);
+    }
+    if (spec_.perCaseNoise) {
+        params.caseId = spec_.base.caseId + static_cast<int>(i);
+    }
+    return params;
+}
+
+// ----------------------------------------------------------
+// runSweep
+// ----------------------------------------------------------
+
+std::vector<SweepCase> runSweep(const SweepSpec &spec, int numThreads) {
+    const ParameterSweep sweep(spec);
+    std::vector<SweepCase> cases(sweep.size());
+
+    // Each worker builds a case's params from its index just before running
+    // it, so at most one params struct per worker exists at a time
+    parallelFor(sweep.size(), numThreads, [&](std::size_t i) {
+        AttitudeSimParams params = sweep.params(i);
+        params.summaryOnly = true;
+        cases[i].index = i;
+        cases[i].coordinates = sweep.coordinates(i);
+        try {
+            cases[i].summary = runSimulation(params).summary;
+        } catch (const std::exception &e) {
+            cases[i].summary = failedSummary();
+            cases[i].error = e.what();
+        }
+    });
+
+    return cases;
+}
+
+} // namespace starSense
@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+
+namespace starSense {
+
+// ----------------------------------------------------------
+// Parameter sweeps / design of experiments
+//
+// A sweep is a base AttitudeSimParams plus axes, each of which varies one
+// numeric parameter (or one component of it). Grid axes form a Cartesian
+// product; sampled axes (Latin hypercube, Sobol, random) share one sample
+// index and contribute `samples` points per grid point. Case i is decoded
+// from its index on demand, so a sweep of a million cases never holds more
+// than one AttitudeSimParams per worker. Sampled values are pure functions
+// of (seed, axis, sample), so a sweep reproduces on any thread count.
+// ----------------------------------------------------------
+
+// Number of numeric components of AttitudeSimParams field `param` (see
+// forEachParam; vectors and matrices count every element). Throws
+// std::invalid_argument for unknown, non-numeric or empty fields.
+std::size_t numericParamSize(const AttitudeSimParams &params, const std::string &param);
+
+// Check that `index` (row-major; -1: every component) addresses numeric
+// field `param` and return the field's component count. Throws
+// std::invalid_argument, prefixed with `where`, for unknown, non-numeric or
+// empty fields and for an index outside [-1, count).
+std::size_t checkNumericParam(const AttitudeSimParams &params, const std::string &param, int index,
+                              const std::string &where);
+
+// Set component `index` (row-major; -1: every component) of numeric field
+// `param` to value, or multiply it by value when scale is set. Integer
+// fields are rounded.
+void setNumericParam(AttitudeSimParams &params, const std::string &param, int index,
+                     double value, bool scale = false);
+
+// Is `param` a task rate (controlRateHz, sensorRateHz, actuatorRateHz)?
+// Rates only take values whose period is a whole number of dt steps (see
+// MultiRateScheduler::periodFromRate), so they cannot be varied continuously.
+bool isTaskRateParam(const std::string &param);
+
+struct SweepAxis {
+    // Parameter by AttitudeSimParams field name (see forEachParam). For
+    // vectors and matrices, `index` picks one component in row-major order
+    // (e.g. 4 is inertiaBody[1][1]); -1 applies the value to every component.
+    std::string param;
+    int index = -1;
+
+    // "grid"    : the listed values
+    // "lhs"     : Latin hypercube on [lo, hi]
+    // "sobol"   : Sobol sequence on [lo, hi] (up to 16 sobol axes)
+    // "uniform" : independent uniform draws on [lo, hi]
+    // "normal"  : independent normal draws, mean lo and standard deviation hi
+    // Task rates (isTaskRateParam) take grid axes only.
+    std::string kind = "grid";
+    std::vector<double> values;  // "grid" only
+    double lo = 0.0;
+    double hi = 1.0;
+
+    // false: the value replaces the base parameter; true: it multiplies it
+    // (relative dispersions such as inertia scale factors)
+    bool scale = false;
+};
+
+struct SweepSpec {
+    AttitudeSimParams base;
+    std::vector<SweepAxis> axes;
+    std::size_t samples = 1;     // points per grid point along the sampled axes
+    std::uint32_t seed = 0;      // lhs / uniform / normal draws
+    bool perCaseNoise = false;   // caseId = base.caseId + case index (independent sensor noise)
+};
+
+// One finished case: its position in the sweep and its run summary
+struct SweepCase {
+    std::size_t index = 0;
+    std::vector<double> coordinates;  // one value per axis, as applied (before scaling)
+    SimulationSummary summary;        // every metric NaN when the case failed
+    std::string error;                // why the case failed (empty: it ran)
+};
+
+// Lazily indexed view of a SweepSpec's cases
+class ParameterSweep {
+public:
+    // Throws std::invalid_argument for unknown or non-numeric parameters,
+    // out-of-range indices, unknown kinds, empty axes or sampled task rates
+    explicit ParameterSweep(SweepSpec spec);
+
+    // Number of cases: product of the grid sizes times samples (or 1 when
+    // there are no sampled axes)
+    std::size_t size() const { return gridSize_ * samplesPerPoint_; }
+
+    const SweepSpec &spec() const { return spec_; }
+
+    // Axis values of case i
+    std::vector<double> coordinates(std::size_t i) const;
+
+    // Parameters of case i: the base with every axis applied
+    AttitudeSimParams params(std::size_t i) const;
+
+private:
+    enum class Kind { Grid, LatinHypercube, Sobol, Uniform, Normal };
+
+    double sampledValue_(std::size_t axis, std::size_t sample) const;
+
+    SweepSpec spec_;
+    std::vector<Kind> kinds_;
+    std::vector<std::array<std::uint32_t, 32>> sobolDirections_;  // per axis (sobol only)
+    std::vector<std::vector<std::uint32_t>> lhsStrata_;           // per axis (lhs only): stratum of each sample
+    std::size_t gridSize_ = 1;
+    std::size_t samplesPerPoint_ = 1;
+};
+
+// Run every case of a sweep on a pool of worker threads. Cases are built
+// and run one at a time by the workers, with summaryOnly set, so only the
+// summaries are kept. A case whose run throws (e.g. a grid rate that is not
+// a whole number of dt steps) is recorded with its error and does not stop
+// the others.
+//  numThreads : worker count (<= 0 uses one per hardware thread)
+// Returns one SweepCase per case, in index order.
+std::vector<SweepCase> runSweep(const SweepSpec &spec, int numThreads = 0);
+
+} // namespace starSense
@@ -0,0 +1,65 @@
+// runSimulationBatch: results come back in input order and match serial
+// runSimulation calls exactly; a failing case's exception reaches the
+// caller.
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+std::vector<AttitudeSimParams> distinctCases(std::size_t count) {
+    std::vector<AttitudeSimParams> cases(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        AttitudeSimParams &params = cases[i];
+        params.dt = 0.01;
+        params.numSteps = 200 + 37 * i;  // uneven lengths so workers interleave
+        params.controllerType = "pd";
+        params.w0 = {0.01 * static_cast<double>(i), -0.02, 0.005 * static_cast<double>(i % 3)};
+    }
+    return cases;
+}
+
+bool sameSeries(const SimulationResult &a, const SimulationResult &b) {
+    return a.time == b.time && a.quats.data == b.quats.data && a.omegas.data == b.omegas.data &&
+           a.commandedTorque.data == b.commandedTorque.data;
+}
+
+void testMatchesSerial() {
+    const std::vector<AttitudeSimParams> cases = distinctCases(13);
+    for (int threads : {1, 4, 0}) {
+        const std::vector<SimulationResult> batch = runSimulationBatch(cases, threads);
+        CHECK(batch.size() == cases.size());
+        for (std::size_t i = 0; i < cases.size() && i < batch.size(); ++i) {
+            CHECK(sameSeries(batch[i], runSimulation(cases[i])));
+        }
+    }
+    CHECK(runSimulationBatch({}, 4).empty());
+}
+
+void testRethrowsCaseError() {
+    std::vector<AttitudeSimParams> cases = distinctCases(8);
+    cases[5].inertiaBody[0][0] = -1.0;
+
+    bool threw = false;
+    try {
+        runSimulationBatch(cases, 4);
+    } catch (const std::invalid_argument &e) {
+        threw = std::string(e.what()).find("positive definite") != std::string::npos;
+    }
+    CHECK(threw);
+    CHECK_THROWS(runSimulationBatch(cases, 1), std::invalid_argument);
+}
+
+} // namespace
+
+int main() {
+    testMatchesSerial();
+    testRethrowsCaseError();
+    return testing::testExitCode();
+}
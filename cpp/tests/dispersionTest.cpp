@@ -0,0 +1,143 @@
+// Dispersion statistics: Welford moments merge exactly, the t-digest
+// estimates quantiles within a small rank error (also after merging), and
+// a dispersion batch of identical runs reproduces the run itself.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "api.hpp"
+#include "dispersion.hpp"
+#include "random.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+std::vector<double> normalSample(std::uint32_t seed, std::size_t blocks) {
+    std::vector<double> values;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        for (double z : philoxNormals(philoxKey(seed, 0u), i, 0u)) {
+            values.push_back(z);
+        }
+    }
+    return values;
+}
+
+void testMoments() {
+    const std::vector<double> values = normalSample(1u, 5000);
+    RunningMoments all, first, second;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        all.add(values[i]);
+        (i < 3000 ? first : second).add(values[i]);
+        sum += values[i];
+    }
+    const double mean = sum / static_cast<double>(values.size());
+    double squares = 0.0;
+    for (double x : values) {
+        squares += (x - mean) * (x - mean);
+    }
+    const double variance = squares / static_cast<double>(values.size() - 1);
+
+    CHECK(all.count() == values.size());
+    CHECK_NEAR(all.mean(), mean, 1e-14);
+    CHECK_NEAR(all.variance(), variance, 1e-12);
+
+    first.merge(second);
+    CHECK(first.count() == values.size());
+    CHECK_NEAR(first.mean(), mean, 1e-14);
+    CHECK_NEAR(first.variance(), variance, 1e-12);
+
+    RunningMoments one;
+    one.add(2.0);
+    CHECK(one.variance() == 0.0);
+}
+
+// Fraction of `sorted` below x
+double rankOf(const std::vector<double> &sorted, double x) {
+    return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) /
+           static_cast<double>(sorted.size());
+}
+
+void testTDigest() {
+    std::vector<double> values = normalSample(2u, 25000);
+    TDigest whole;
+    std::vector<TDigest> parts(4);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        whole.add(values[i]);
+        parts[i % parts.size()].add(values[i]);
+    }
+    whole.compress();
+    TDigest merged;
+    for (TDigest &part : parts) {
+        part.compress();
+        merged.merge(part);
+    }
+    merged.compress();
+
+    std::sort(values.begin(), values.end());
+    CHECK(whole.count() == static_cast<double>(values.size()));
+    CHECK(merged.count() == static_cast<double>(values.size()));
+    for (double q : {0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+        CHECK_NEAR(rankOf(values, whole.quantile(q)), q, 0.005);
+        CHECK_NEAR(rankOf(values, merged.quantile(q)), q, 0.005);
+    }
+    CHECK(whole.quantile(0.0) == values.front());
+    CHECK(whole.quantile(1.0) == values.back());
+    CHECK(std::isnan(TDigest().quantile(0.5)));
+}
+
+void testIdenticalRuns() {
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 500;
+    params.controllerType = "pd";
+    params.w0 = {0.1, -0.05, 0.02};
+
+    const SimulationResult run = runSimulation(params);
+    DispersionConfig config;
+    config.channels = {"omegas"};
+    const DispersionStatistics stats = runDispersionBatch({params, params, params}, config, 2);
+
+    CHECK(stats.runs == 3);
+    CHECK(stats.time.size() == run.time.size());
+    const ChannelEnvelope &omegas = stats.channel("omegas");
+    for (std::size_t b = 0; b < stats.time.size() && b < run.omegas.size(); ++b) {
+        CHECK(omegas.count[b] == 3);
+        for (std::size_t k = 0; k < 3; ++k) {
+            CHECK_NEAR(omegas.mean.row(b)[k], run.omegas.row(b)[k], 1e-15);
+            CHECK_NEAR(omegas.stddev.row(b)[k], 0.0, 1e-15);
+            CHECK_NEAR(omegas.quantiles[1].row(b)[k], run.omegas.row(b)[k], 1e-15);
+        }
+    }
+}
+
+void testDefaultBinCap() {
+    // 20000 logged samples fold into kDefaultDispersionBins bins
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 20000;
+    DispersionConfig config;
+    config.channels = {"omegas"};
+    const DispersionStatistics stats = runDispersionBatch({params, params}, config, 1);
+    CHECK(stats.time.size() == kDefaultDispersionBins);
+    CHECK_NEAR(stats.time.back(), 200.0, 1e-9);
+
+    std::size_t samples = 0;
+    for (std::size_t count : stats.channel("omegas").count) {
+        samples += count;
+    }
+    CHECK(samples == 2 * 20001);
+}
+
+} // namespace
+
+int main() {
+    testMoments();
+    testTDigest();
+    testIdenticalRuns();
+    testDefaultBinCap();
+    return testing::testExitCode();
+}
@@ -0,0 +1,72 @@
+// Events: the fixed-step and adaptive paths locate the same crossings,
+// and a terminal event ends the run at the crossing.
+
+#include <string>
+
+#include "api.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+AttitudeSimParams slewCase(const std::string &integrator) {
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 3000;
+    params.integratorType = integrator;
+    params.controllerType = "pd";
+    params.kpAtt = {0.5, 0.5, 0.5};
+    params.kdRate = {1.5, 1.5, 1.5};
+    params.q0 = {0.9238795325112867, 0.3826834323650898, 0.0, 0.0};  // 45 deg about x
+    params.eventAttitudeError = 0.05;
+    params.eventRateError = 0.01;
+    params.summaryOnly = true;
+    return params;
+}
+
+void checkSameEvents(const SimulationResult &a, const SimulationResult &b, double tol) {
+    CHECK(a.events.size() == b.events.size());
+    CHECK(!a.events.empty());
+    for (std::size_t i = 0; i < a.events.size() && i < b.events.size(); ++i) {
+        CHECK(a.events[i].name == b.events[i].name);
+        CHECK_NEAR(a.events[i].t, b.events[i].t, tol);
+    }
+}
+
+void testEventTimesAgree() {
+    // Torque updated every tick
+    checkSameEvents(runSimulation(slewCase("rk4")), runSimulation(slewCase("rk45")), 1e-5);
+
+    // Torque held for a second: rk45 takes long steps between actuator
+    // ticks and locates the crossings on its dense output
+    AttitudeSimParams rk4 = slewCase("rk4");
+    AttitudeSimParams rk45 = slewCase("rk45");
+    rk4.controlRateHz = rk45.controlRateHz = 1.0;
+    const SimulationResult fixed = runSimulation(rk4);
+    const SimulationResult adaptive = runSimulation(rk45);
+    checkSameEvents(fixed, adaptive, 1e-5);
+    CHECK(adaptive.integratorStats.acceptedSteps < fixed.integratorStats.acceptedSteps / 10);
+}
+
+void testTerminalEventEndsRun() {
+    for (const char *integrator : {"rk4", "rk45"}) {
+        AttitudeSimParams params = slewCase(integrator);
+        params.summaryOnly = false;
+        params.stopOnEvent = true;
+        const SimulationResult result = runSimulation(params);
+        CHECK(result.terminated);
+        CHECK(result.events.size() == 1);
+        if (!result.events.empty()) {
+            CHECK(result.time.back() == result.events.front().t);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testEventTimesAgree();
+    testTerminalEventEndsRun();
+    return testing::testExitCode();
+}
@@ -0,0 +1,69 @@
+// Integrators: RKMK4 keeps the attitude on the unit sphere and agrees with
+// RK4, and the compile-time and run-time integrators take identical steps.
+
+#include <cmath>
+
+#include "api.hpp"
+#include "dynamics.hpp"
+#include "integrator.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+double quatNorm(const double *q) {
+    return std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+}
+
+void testRkmk4() {
+    // Torque-free tumble of an asymmetric body
+    AttitudeSimParams params;
+    params.dt = 0.02;
+    params.numSteps = 5000;
+    params.inertiaBody = {{{1.0, 0.0, 0.0}, {0.0, 2.0, 0.0}, {0.0, 0.0, 3.0}}};
+    params.w0 = {0.3, 1.0, -0.4};
+
+    params.integratorType = "rkmk4";
+    const SimulationResult lie = runSimulation(params);
+    params.integratorType = "rk4";
+    const SimulationResult rk4 = runSimulation(params);
+
+    for (std::size_t i = 0; i < lie.quats.size(); ++i) {
+        CHECK_NEAR(quatNorm(lie.quats.row(i)), 1.0, 1e-12);
+    }
+    const std::size_t last = lie.quats.size() - 1;
+    // Same attitude up to sign; both are 4th order at this step
+    const double *a = lie.quats.row(last);
+    const double *b = rk4.quats.row(last);
+    const double d = std::abs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+    CHECK_NEAR(d, 1.0, 1e-8);
+    for (std::size_t k = 0; k < 3; ++k) {
+        CHECK_NEAR(lie.omegas.row(last)[k], rk4.omegas.row(last)[k], 1e-6);
+    }
+}
+
+void testStaticMatchesRuntime() {
+    const Mat3 J{{{1.0, 0.1, 0.0}, {0.1, 2.0, 0.0}, {0.0, 0.0, 3.0}}};
+    const RigidBodyDynamics dynamics(J);
+    const AttitudeState x{{1.0, 0.0, 0.0, 0.0}, {0.2, -0.1, 0.3}, {0.0, 0.0, 0.0}};
+    const Vec3 tau{0.01, 0.0, -0.02};
+
+    auto same = [](const AttitudeState &a, const AttitudeState &b) {
+        return a.q == b.q && a.w == b.w && a.h == b.h;
+    };
+    CHECK(same(Integrator(IntegrationMethod::Euler).step(dynamics, 0.0, x, 0.1, tau),
+               StaticIntegrator<IntegrationMethod::Euler>().step(dynamics, 0.0, x, 0.1, tau)));
+    CHECK(same(Integrator(IntegrationMethod::RK4).step(dynamics, 0.0, x, 0.1, tau),
+               StaticIntegrator<IntegrationMethod::RK4>().step(dynamics, 0.0, x, 0.1, tau)));
+    CHECK(same(Integrator(IntegrationMethod::RKMK4).step(dynamics, 0.0, x, 0.1, tau),
+               StaticIntegrator<IntegrationMethod::RKMK4>().step(dynamics, 0.0, x, 0.1, tau)));
+}
+
+} // namespace
+
+int main() {
+    testRkmk4();
+    testStaticMatchesRuntime();
+    return testing::testExitCode();
+}
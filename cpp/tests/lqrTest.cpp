@@ -0,0 +1,68 @@
+// lqrAttitudeGain against the closed-form double-integrator solution.
+//
+// With a diagonal inertia the model decouples into one double integrator
+// per axis, phi'' = tau / j. Writing P = [p1 p2; p2 p3], the Riccati
+// equation gives p2 = j sqrt(q r), p3 = j sqrt(r (2 p2 + qRate)), so
+//   K = [sqrt(q / r), sqrt((2 j sqrt(q r) + qRate) / r)]
+// for each axis, with no coupling between axes.
+
+#include <cmath>
+#include <stdexcept>
+
+#include "lqr.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+void checkAgainstClosedForm(const Vec3 &inertia, const Vec3 &qAtt, const Vec3 &qRate, const Vec3 &r) {
+    Mat3 J{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        J[i][i] = inertia[i];
+    }
+    const Mat3x6 K = lqrAttitudeGain(J, qAtt, qRate, r);
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        const double kAtt = std::sqrt(qAtt[i] / r[i]);
+        const double kRate = std::sqrt((2.0 * inertia[i] * std::sqrt(qAtt[i] * r[i]) + qRate[i]) / r[i]);
+        CHECK_NEAR(K[i][i], kAtt, 1e-9 * kAtt);
+        CHECK_NEAR(K[i][i + 3], kRate, 1e-9 * kRate);
+        for (std::size_t j = 0; j < 3; ++j) {
+            if (j != i) {
+                CHECK_NEAR(K[i][j], 0.0, 1e-9 * kAtt);
+                CHECK_NEAR(K[i][j + 3], 0.0, 1e-9 * kRate);
+            }
+        }
+    }
+}
+
+void testClosedForm() {
+    checkAgainstClosedForm({1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+    checkAgainstClosedForm({2.0, 3.0, 4.0}, {4.0, 9.0, 0.5}, {1.0, 0.0, 2.0}, {0.1, 1.0, 10.0});
+
+    // Small spacecraft: scale must not matter
+    checkAgainstClosedForm({1e-6, 2e-6, 3e-6}, {1.0, 1.0, 1.0}, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+}
+
+void testRejectsBadInput() {
+    const Mat3 I{{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}};
+    const Mat3 singular{{{1.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 1.0}}};
+    const Mat3 indefinite{{{1.0, 0.0, 0.0}, {0.0, -1.0, 0.0}, {0.0, 0.0, 1.0}}};
+    const Vec3 one{1.0, 1.0, 1.0};
+    const Vec3 zero{0.0, 0.0, 0.0};
+
+    CHECK_THROWS(lqrAttitudeGain(singular, one, zero, one), std::invalid_argument);
+    CHECK_THROWS(lqrAttitudeGain(indefinite, one, zero, one), std::invalid_argument);
+    CHECK_THROWS(lqrAttitudeGain(I, zero, zero, one), std::invalid_argument);
+    CHECK_THROWS(lqrAttitudeGain(I, one, Vec3{-1.0, 0.0, 0.0}, one), std::invalid_argument);
+    CHECK_THROWS(lqrAttitudeGain(I, one, zero, zero), std::invalid_argument);
+}
+
+} // namespace
+
+int main() {
+    testClosedForm();
+    testRejectsBadInput();
+    return testing::testExitCode();
+}
@@ -0,0 +1,121 @@
+// Config readers: JSON, JSON Lines and the TOML subset produce the
+// expected cases, errors carry the source line, and paramsToJson output
+// reads back to the same parameters.
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "paramsFile.hpp"
+#include "paramsJson.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+bool throwsMentioning(const std::string &text, bool toml, const std::string &needle) {
+    try {
+        if (toml) {
+            paramsListFromToml(text, "case.toml");
+        } else {
+            paramsListFromJson(text, "case.json");
+        }
+    } catch (const std::invalid_argument &e) {
+        return std::string(e.what()).find(needle) != std::string::npos;
+    }
+    return false;
+}
+
+void testJson() {
+    const auto single = paramsListFromJson(R"({"dt": 0.02, "numSteps": 10, "w0": [0.1, -0.2, 0.3]})");
+    CHECK(single.size() == 1);
+    CHECK(single[0].dt == 0.02);
+    CHECK(single[0].numSteps == 10);
+    CHECK(single[0].w0[1] == -0.2);
+    CHECK(single[0].controllerType == AttitudeSimParams{}.controllerType);  // unset: default
+
+    const auto array = paramsListFromJson(R"([{"controllerType": "pd"}, {"controllerType": "lqr_auto",}])");
+    CHECK(array.size() == 2);
+    CHECK(array[1].controllerType == "lqr_auto");
+
+    const auto lines = paramsListFromJson("{\"caseId\": 1}\n{\"caseId\": 2}\n{\"caseId\": 3}\n");
+    CHECK(lines.size() == 3);
+    CHECK(lines[2].caseId == 3);
+
+    const auto nested = paramsListFromJson(
+        R"({"inertiaBody": [[1, 0, 0], [0, 2, 0], [0, 0, 3]], "wheelAxes": [[1, 0, 0], [0, 1, 0]]})");
+    CHECK(nested[0].inertiaBody[2][2] == 3.0);
+    CHECK(nested[0].wheelAxes.size() == 2);
+
+    const auto escapes = paramsListFromJson(R"({"trajectoryPath": "a\tb\"c\\dé\u0001"})");
+    CHECK(escapes[0].trajectoryPath == "a\tb\"c\\d\xc3\xa9\x01");
+}
+
+void testToml() {
+    const auto cases = paramsListFromToml(
+        "# shared defaults\n"
+        "dt = 0.01\n"
+        "controllerType = \"pd\"\n"
+        "kpAtt = [2.0,\n"
+        "         2.0, 2.0]   # spans lines\n"
+        "\n"
+        "[[cases]]\n"
+        "w0 = [0.1, 0.0, 0.0]\n"
+        "\n"
+        "[[cases]]\n"
+        "w0 = [0.0, 0.1, 0.0]\n"
+        "controllerType = \"lqr_auto\"\n");
+    CHECK(cases.size() == 2);
+    CHECK(cases[0].dt == 0.01 && cases[1].dt == 0.01);
+    CHECK(cases[0].kpAtt[2] == 2.0);
+    CHECK(cases[0].controllerType == "pd");
+    CHECK(cases[1].controllerType == "lqr_auto");
+    CHECK(cases[1].w0[1] == 0.1);
+
+    const auto single = paramsListFromToml("numSteps = 7\n");
+    CHECK(single.size() == 1);
+    CHECK(single[0].numSteps == 7);
+}
+
+void testErrors() {
+    CHECK(throwsMentioning("{\"dt\": 0.01,\n \"nope\": 1}", false, "case.json:2"));
+    CHECK(throwsMentioning("{\"dt\": 0.01,\n \"nope\": 1}", false, "unknown parameter 'nope'"));
+    CHECK(throwsMentioning(R"({"w0": [1, 2]})", false, "expected 3 elements"));
+    CHECK(throwsMentioning(R"({"numSteps": 1.5})", false, "expected an integer"));
+    CHECK(throwsMentioning(R"({"trajectoryPath": "\q"})", false, "unsupported escape"));
+    CHECK(throwsMentioning("", false, "no cases"));
+    CHECK(throwsMentioning("dt = 0.01\n[[runs]]\n", true, "case.toml:2"));
+}
+
+void testJsonRoundTrip() {
+    AttitudeSimParams params;
+    params.dt = 0.1 + 0.2;  // not exactly representable in short decimal
+    params.w0 = {1e-300, -0.0, 3.141592653589793};
+    params.maxWheelSpeed = {std::numeric_limits<double>::infinity(), 1234.5, 6000.0};
+    params.trajectoryPath = "dir/run\x01\n.sstraj";
+    params.controllerType = "lqr_auto";
+
+    const std::string json = paramsToJson(params);
+    CHECK(json.find("inf") == std::string::npos);
+    CHECK(json.find('\x01') == std::string::npos);
+
+    const auto back = paramsListFromJson(json);
+    CHECK(back.size() == 1);
+    CHECK(paramsToJson(back[0]) == json);
+    CHECK(back[0].dt == params.dt);
+    CHECK(back[0].w0 == params.w0);
+    CHECK(std::isinf(back[0].maxWheelSpeed[0]) && back[0].maxWheelSpeed[0] > 0.0);
+    CHECK(back[0].trajectoryPath == params.trajectoryPath);
+}
+
+} // namespace
+
+int main() {
+    testJson();
+    testToml();
+    testErrors();
+    testJsonRoundTrip();
+    return testing::testExitCode();
+}
@@ -0,0 +1,78 @@
+// Philox4x32-10 against the Random123 known-answer vectors (kat_vectors),
+// and the derived uniform / normal draws.
+
+#include <cmath>
+#include <cstddef>
+
+#include "random.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+void checkBlock(const PhiloxCounter &ctr, const PhiloxKey &key, const PhiloxCounter &expected) {
+    const PhiloxCounter out = philox4x32(ctr, key);
+    for (std::size_t i = 0; i < 4; ++i) {
+        CHECK(out[i] == expected[i]);
+    }
+}
+
+void testKnownAnswers() {
+    checkBlock({0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u},
+               {0x00000000u, 0x00000000u},
+               {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u});
+    checkBlock({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+               {0xffffffffu, 0xffffffffu},
+               {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu});
+    checkBlock({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+               {0xa4093822u, 0x299f31d0u},
+               {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u});
+}
+
+void testUniformRange() {
+    CHECK(uniformOpen01(0u) > 0.0);
+    CHECK(uniformOpen01(0xffffffffu) < 1.0);
+}
+
+void testNormalMoments() {
+    // Mean and variance of many draws from one stream
+    const PhiloxKey key = philoxKey(7u, 3u);
+    const std::size_t blocks = 50000;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        for (double z : philoxNormals(key, i, 0u)) {
+            CHECK(std::isfinite(z));
+            sum += z;
+            sumSquares += z * z;
+        }
+    }
+    const double n = 4.0 * static_cast<double>(blocks);
+    const double mean = sum / n;
+    CHECK_NEAR(mean, 0.0, 0.01);
+    CHECK_NEAR(sumSquares / n - mean * mean, 1.0, 0.01);
+
+    // Pure function of (key, index, stream)
+    const auto a = philoxNormals(key, 12345u, 1u);
+    const auto b = philoxNormals(key, 12345u, 1u);
+    const auto c = philoxNormals(key, 12345u, 2u);
+    CHECK(a == b);
+    CHECK(a != c);
+
+    // The block form matches one block at a time
+    double block[4 * 5];
+    fillPhiloxNormals(key, 1u, 12343u, 5, block);
+    for (std::size_t k = 0; k < 4; ++k) {
+        CHECK(block[4 * 2 + k] == a[k]);
+    }
+}
+
+} // namespace
+
+int main() {
+    testKnownAnswers();
+    testUniformRange();
+    testNormalMoments();
+    return testing::testExitCode();
+}
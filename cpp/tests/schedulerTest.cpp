@@ -0,0 +1,54 @@
+// Multi-rate scheduling: rates map to whole tick periods, and tasks that
+// never need to rerun leave an adaptive integrator free to take long steps.
+
+#include <stdexcept>
+
+#include "api.hpp"
+#include "scheduler.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+void testPeriodFromRate() {
+    CHECK(MultiRateScheduler::periodFromRate(10.0, 0.01, "rate") == 10);
+    CHECK(MultiRateScheduler::periodFromRate(100.0, 0.01, "rate") == 1);
+    CHECK(MultiRateScheduler::periodFromRate(0.0, 0.01, "rate") == 1);
+    CHECK_THROWS(MultiRateScheduler::periodFromRate(7.0, 0.01, "rate"), std::invalid_argument);
+    CHECK_THROWS(MultiRateScheduler::periodFromRate(200.0, 0.01, "rate"), std::invalid_argument);
+}
+
+void testCoastingWheelsTakeLongSteps() {
+    // Zero controller: with default (finite) wheel speed limits the wheels
+    // hold their torque, so rk45 is not forced onto every tick
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 10000;
+    params.integratorType = "rk45";
+    params.controllerType = "zero";
+    params.actuatorType = "reactionWheel";
+    params.w0 = {0.01, 0.0, 0.0};
+    params.summaryOnly = true;
+    const SimulationResult coast = runSimulation(params);
+    CHECK(coast.integratorStats.acceptedSteps < params.numSteps / 10);
+
+    // Momentum management changes the torque by itself and keeps the
+    // actuator on every tick
+    params.wheelAxes = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}, {0.57735, 0.57735, 0.57735}};
+    params.wheelInertias = {0.01, 0.01, 0.01, 0.01};
+    params.maxWheelTorque = {0.1, 0.1, 0.1, 0.1};
+    params.maxWheelSpeed = {6000, 6000, 6000, 6000};
+    params.wheelSpeeds0 = {100.0, 0.0, 0.0, 0.0};
+    params.nullSpaceGain = 0.1;
+    const SimulationResult managed = runSimulation(params);
+    CHECK(managed.integratorStats.acceptedSteps >= params.numSteps);
+}
+
+} // namespace
+
+int main() {
+    testPeriodFromRate();
+    testCoastingWheelsTakeLongSteps();
+    return testing::testExitCode();
+}
@@ -0,0 +1,118 @@
+// The streamed summary metrics equal the same metrics recomputed from the
+// full logged history, and summaryOnly runs report the same summary.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "api.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+double norm3(const double *v) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+AttitudeSimParams saturatingCase() {
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 4000;
+    params.controllerType = "pd";
+    params.actuatorType = "reactionWheel";
+    params.maxWheelTorque = {0.05, 0.05, 0.05};  // saturates early in the slew
+    params.q0 = {0.8660254037844387, 0.0, 0.5, 0.0};  // 60 deg about y
+    params.summaryMetrics = true;
+    params.settlingAttitudeError = 0.01;
+    params.rmsStartTime = 10.0;
+    return params;
+}
+
+void testMatchesHistory() {
+    const AttitudeSimParams params = saturatingCase();
+    const SimulationResult result = runSimulation(params);
+    const SimulationSummary &s = result.summary;
+    const std::size_t n = result.time.size();
+    CHECK(s.samples == n);
+    CHECK(s.endTime == result.time.back());
+
+    double peakAtt = -1.0, peakAttTime = 0.0, peakRate = 0.0;
+    double sumSquares = 0.0;
+    std::size_t rmsSamples = 0;
+    double settling = std::numeric_limits<double>::quiet_NaN();
+    double maxWheel = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = result.time[i];
+        const double eAtt = norm3(result.attitudeError.row(i));
+        const double eW = norm3(result.rateError.row(i));
+        if (eAtt > peakAtt) {
+            peakAtt = eAtt;
+            peakAttTime = t;
+        }
+        peakRate = std::max(peakRate, eW);
+        if (t >= params.rmsStartTime) {
+            sumSquares += eAtt * eAtt;
+            ++rmsSamples;
+        }
+        if (eAtt > params.settlingAttitudeError) {
+            settling = std::numeric_limits<double>::quiet_NaN();
+        } else if (std::isnan(settling)) {
+            settling = t;
+        }
+        for (std::size_t w = 0; w < result.wheelSpeeds.width; ++w) {
+            maxWheel = std::max(maxWheel, std::abs(result.wheelSpeeds.row(i)[w]));
+        }
+    }
+
+    // Torques are held from each sample to the next
+    const double tolerance = SummaryConfig{}.saturationTolerance;
+    double impulse = 0.0, saturation = 0.0;
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        const double span = result.time[i + 1] - result.time[i];
+        const double *commanded = result.commandedTorque.row(i);
+        const double *applied = result.appliedTorque.row(i);
+        impulse += norm3(applied) * span;
+        bool saturated = false;
+        for (std::size_t k = 0; k < 3; ++k) {
+            saturated |= std::abs(commanded[k] - applied[k]) > tolerance;
+        }
+        saturation += saturated ? span : 0.0;
+    }
+
+    CHECK_NEAR(s.peakAttitudeError, peakAtt, 1e-15);
+    CHECK_NEAR(s.peakAttitudeErrorTime, peakAttTime, 1e-15);
+    CHECK_NEAR(s.peakRateError, peakRate, 1e-15);
+    CHECK_NEAR(s.rmsAttitudeError, std::sqrt(sumSquares / static_cast<double>(rmsSamples)), 1e-12);
+    CHECK_NEAR(s.finalAttitudeError, norm3(result.attitudeError.row(n - 1)), 1e-15);
+    CHECK_NEAR(s.finalRateError, norm3(result.rateError.row(n - 1)), 1e-15);
+    CHECK(!std::isnan(settling));
+    CHECK_NEAR(s.settlingTime, settling, 1e-12);
+    CHECK_NEAR(s.controlImpulse, impulse, 1e-9 * impulse);
+    CHECK(saturation > 0.0);
+    CHECK_NEAR(s.saturationTime, saturation, 1e-9);
+    CHECK_NEAR(s.maxWheelSpeed, maxWheel, 1e-12);
+}
+
+void testSummaryOnlyMatches() {
+    AttitudeSimParams params = saturatingCase();
+    const SimulationSummary full = runSimulation(params).summary;
+    params.summaryOnly = true;
+    const SimulationResult light = runSimulation(params);
+    CHECK(light.time.empty());
+    CHECK(light.summary.samples == full.samples);
+    CHECK(light.summary.peakAttitudeError == full.peakAttitudeError);
+    CHECK(light.summary.rmsAttitudeError == full.rmsAttitudeError);
+    CHECK(light.summary.settlingTime == full.settlingTime);
+    CHECK(light.summary.controlImpulse == full.controlImpulse);
+    CHECK(light.summary.maxWheelSpeed == full.maxWheelSpeed);
+}
+
+} // namespace
+
+int main() {
+    testMatchesHistory();
+    testSummaryOnlyMatches();
+    return testing::testExitCode();
+}
@@ -0,0 +1,63 @@
+// Parameter sweeps: task rates take grid axes only, and a case that fails
+// is recorded with its error without stopping the rest of the sweep.
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+#include "sweep.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+SweepSpec rateSweep() {
+    SweepSpec spec;
+    spec.base.dt = 0.01;
+    spec.base.numSteps = 200;
+    spec.base.controllerType = "pd";
+    spec.base.w0 = {0.02, -0.01, 0.0};
+    SweepAxis rate;
+    rate.param = "controlRateHz";
+    rate.values = {10.0, 7.0, 20.0};  // 7 Hz is not a whole number of dt steps
+    spec.axes = {rate};
+    return spec;
+}
+
+void testSampledRateAxisRejected() {
+    SweepSpec spec = rateSweep();
+    spec.axes[0].kind = "lhs";
+    spec.axes[0].lo = 5.0;
+    spec.axes[0].hi = 20.0;
+    spec.samples = 8;
+    CHECK_THROWS(ParameterSweep{spec}, std::invalid_argument);
+}
+
+void testFailedCaseKeepsSweepRunning() {
+    const std::vector<SweepCase> cases = runSweep(rateSweep(), 2);
+    CHECK(cases.size() == 3);
+    if (cases.size() != 3) {
+        return;
+    }
+    for (std::size_t i : {0u, 2u}) {
+        CHECK(cases[i].error.empty());
+        CHECK(cases[i].summary.samples == 201);
+        CHECK(!std::isnan(cases[i].summary.rmsAttitudeError));
+    }
+    CHECK(cases[1].coordinates == std::vector<double>{7.0});
+    CHECK(cases[1].error.find("controlRateHz") != std::string::npos);
+    CHECK(cases[1].summary.samples == 0);
+    CHECK(std::isnan(cases[1].summary.rmsAttitudeError));
+    CHECK(std::isnan(cases[1].summary.endTime));
+}
+
+} // namespace
+
+int main() {
+    testSampledRateAxisRejected();
+    testFailedCaseKeepsSweepRunning();
+    return testing::testExitCode();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// ----------------------------------------------------------
+// Minimal checks for the unit test executables (no framework)
+//
+// Each test file is one executable registered with ctest. A failed check
+// prints its location and keeps going, so one run reports every failure;
+// main returns testExitCode() so ctest sees the result.
+// ----------------------------------------------------------
+
+namespace starSense::testing {
+
+inline int &failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char *file, int line, const char *what) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    ++failureCount();
+}
+
+inline int testExitCode() {
+    if (failureCount() > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failureCount());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace starSense::testing
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            ::starSense::testing::fail(__FILE__, __LINE__, #cond);         \
+        }                                                                  \
+    } while (0)
+
+// |a - b| <= tol, printing both values on failure
+#define CHECK_NEAR(a, b, tol)                                              \
+    do {                                                                   \
+        const double checkA_ = (a);                                        \
+        const double checkB_ = (b);                                        \
+        if (!(std::abs(checkA_ - checkB_) <= (tol))) {                     \
+            char checkMsg_[256];                                           \
+            std::snprintf(checkMsg_, sizeof(checkMsg_),                    \
+                          "%s ~ %s (%.17g vs %.17g, tol %g)", #a, #b,      \
+                          checkA_, checkB_, static_cast<double>(tol));     \
+            ::starSense::testing::fail(__FILE__, __LINE__, checkMsg_);     \
+        }                                                                  \
+    } while (0)
+
+// expr throws an exception of type E
+#define CHECK_THROWS(expr, E)                                              \
+    do {                                                                   \
+        bool checkThrew_ = false;                                          \
+        try {                                                              \
+            (void)(expr);                                                  \
+        } catch (const E &) {                                              \
+            checkThrew_ = true;                                            \
+        } catch (...) {                                                    \
+        }                                                                  \
+        if (!checkThrew_) {                                                \
+            ::starSense::testing::fail(__FILE__, __LINE__,                 \
+                                       #expr " throws " #E);               \
+        }                                                                  \
+    } while (0)
@@ -0,0 +1,121 @@
+// Trajectory files round-trip the logged channels bit for bit, and the
+// reader rejects damaged files instead of mapping past their end.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "api.hpp"
+#include "paramsJson.hpp"
+#include "testing.hpp"
+
+using namespace starSense;
+
+namespace {
+
+AttitudeSimParams wheelCase() {
+    AttitudeSimParams params;
+    params.dt = 0.01;
+    params.numSteps = 2500;  // several writer chunks
+    params.logChunkSize = 512;
+    params.controllerType = "pd";
+    params.actuatorType = "reactionWheel";
+    params.w0 = {0.05, -0.02, 0.03};
+    params.derivedChannels = true;
+    return params;
+}
+
+void testRoundTrip() {
+    const std::string path = "trajectoryFileTest.sstraj";
+    const AttitudeSimParams params = wheelCase();
+    const SimulationResult memory = runSimulation(params);
+
+    AttitudeSimParams toFile = params;
+    toFile.trajectoryPath = path;
+    runSimulation(toFile);
+
+    const TrajectoryFile file(path);
+    CHECK(file.metadata() == paramsToJson(toFile));
+
+    std::size_t channels = 0;
+    memory.forEachChannel([&](const char *name, const auto &series, bool) {
+        ++channels;
+        const TrajectoryChannel &channel = file.channel(name);
+        const std::size_t width = channelWidth(series);
+        const std::size_t values = series.size() * width;
+        CHECK(channel.dtype == TrajectoryDtype::Float64);
+        CHECK(channel.width == width);
+        CHECK(channel.rows == series.size());
+        if (channel.rows == series.size() && values > 0) {
+            CHECK(std::memcmp(channel.data, channelData(series), values * sizeof(double)) == 0);
+        }
+    });
+    CHECK(file.channels().size() == channels);
+    std::remove(path.c_str());
+}
+
+void testFloat32() {
+    const std::string path = "trajectoryFileTest32.sstraj";
+    AttitudeSimParams params = wheelCase();
+    const SimulationResult memory = runSimulation(params);
+    params.trajectoryPath = path;
+    params.trajectoryFloat32 = true;
+    runSimulation(params);
+
+    const TrajectoryFile file(path);
+    CHECK(file.channel("time").dtype == TrajectoryDtype::Float64);
+
+    const TrajectoryChannel &omegas = file.channel("omegas");
+    CHECK(omegas.dtype == TrajectoryDtype::Float32);
+    CHECK(omegas.rows == memory.omegas.size());
+    const float *data = static_cast<const float *>(omegas.data);
+    for (std::size_t i = 0; i < memory.omegas.data.size(); ++i) {
+        CHECK(data[i] == static_cast<float>(memory.omegas.data[i]));
+    }
+    std::remove(path.c_str());
+}
+
+void testRejectsDamagedFiles() {
+    const std::string path = "trajectoryFileTest.sstraj";
+    AttitudeSimParams params = wheelCase();
+    params.trajectoryPath = path;
+    runSimulation(params);
+
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [&](const std::vector<char> &content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+
+    // Truncated: the channel data runs past the end
+    rewrite(std::vector<char>(bytes.begin(), bytes.begin() + static_cast<long>(bytes.size() / 2)));
+    CHECK_THROWS(TrajectoryFile(path), std::runtime_error);
+
+    // Row count of the first channel (offset 64 + 56) so large that
+    // rows * width * dtype wraps around 2^64
+    std::vector<char> corrupt = bytes;
+    const std::uint64_t rows = 0x2000000000000001ull;
+    std::memcpy(corrupt.data() + 64 + 56, &rows, sizeof(rows));
+    rewrite(corrupt);
+    CHECK_THROWS(TrajectoryFile(path), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testFloat32();
+    testRejectsDamagedFiles();
+    return testing::testExitCode();
+}
@@ -0,0 +1,122 @@
+// WheelAllocator: the allocated torques realize the command on full-rank
+// arrays (its least-squares part on under-actuated ones), null-space
+// corrections exert no body torque, and saturation keeps the direction.
+
+#include <cmath>
+#include <vector>
+
+#include "testing.hpp"
+#include "wheelAllocator.hpp"
+
+using namespace starSense;
+
+namespace {
+
+const double kS = 1.0 / std::sqrt(3.0);
+
+// 4-wheel pyramid
+const std::vector<Vec3> kPyramid = {{kS, kS, kS}, {-kS, kS, kS}, {kS, -kS, kS}, {-kS, -kS, kS}};
+
+void checkTorque(const Vec3 &actual, const Vec3 &expected, double tol) {
+    for (std::size_t k = 0; k < 3; ++k) {
+        CHECK_NEAR(actual[k], expected[k], tol);
+    }
+}
+
+void testFullRank() {
+    const Vec3 tau{0.01, -0.02, 0.005};
+    for (const std::vector<Vec3> &axes : {
+             std::vector<Vec3>{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}},
+             std::vector<Vec3>{{1.0, 0.0, 0.0}, {1.0, 1.0, 0.0}, {0.0, 1.0, 1.0}},  // skewed, unnormalized
+             kPyramid}) {
+        const WheelAllocator allocator(axes);
+        CHECK(allocator.rank() == 3);
+        std::vector<double> u(allocator.size());
+        allocator.allocate(tau, u.data());
+        checkTorque(allocator.bodyTorque(u.data()), tau, 1e-15);
+    }
+
+    // Minimum norm on the pyramid: u is orthogonal to the null space
+    // direction (1, -1, -1, 1)
+    const WheelAllocator pyramid(kPyramid);
+    std::vector<double> u(4);
+    pyramid.allocate(tau, u.data());
+    CHECK_NEAR(u[0] - u[1] - u[2] + u[3], 0.0, 1e-15);
+}
+
+void testNullSpace() {
+    const WheelAllocator pyramid(kPyramid);
+    std::vector<double> v = {0.3, -0.1, 0.7, 0.2};
+    pyramid.nullSpaceCorrection(v.data(), 2.0, v.data());
+    checkTorque(pyramid.bodyTorque(v.data()), {0.0, 0.0, 0.0}, 1e-15);
+    CHECK(std::abs(v[0]) > 0.0);
+
+    // Three independent wheels have no null space
+    const WheelAllocator triad({{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}});
+    std::vector<double> w = {1.0, 2.0, 3.0};
+    triad.nullSpaceCorrection(w.data(), 1.0, w.data());
+    CHECK(w[0] == 0.0 && w[1] == 0.0 && w[2] == 0.0);
+}
+
+void testUnderActuated() {
+    const Vec3 tau{1.0, 2.0, 3.0};
+
+    const WheelAllocator single({{0.0, 0.0, 2.0}});
+    CHECK(single.rank() == 1);
+    std::vector<double> u1(1);
+    single.allocate(tau, u1.data());
+    checkTorque(single.bodyTorque(u1.data()), {0.0, 0.0, 3.0}, 1e-15);
+
+    const WheelAllocator pair({{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}});
+    CHECK(pair.rank() == 2);
+    std::vector<double> u2(2);
+    pair.allocate(tau, u2.data());
+    checkTorque(pair.bodyTorque(u2.data()), {1.0, 2.0, 0.0}, 1e-15);
+
+    // Coplanar triple: rank 2 with a one-dimensional null space
+    const WheelAllocator coplanar({{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {1.0, 1.0, 0.0}});
+    CHECK(coplanar.rank() == 2);
+    std::vector<double> u3(3);
+    coplanar.allocate(tau, u3.data());
+    checkTorque(coplanar.bodyTorque(u3.data()), {1.0, 2.0, 0.0}, 1e-14);
+    std::vector<double> v = {1.0, 0.0, 0.0};
+    coplanar.nullSpaceCorrection(v.data(), 1.0, v.data());
+    checkTorque(coplanar.bodyTorque(v.data()), {0.0, 0.0, 0.0}, 1e-15);
+    CHECK(std::abs(v[0]) > 0.1);
+}
+
+void testSaturation() {
+    const WheelAllocator pyramid(kPyramid);
+    const Vec3 tau{0.5, -0.2, 0.1};
+    std::vector<double> u(4);
+    pyramid.allocate(tau, u.data());
+
+    const std::vector<double> limit(4, 0.05);
+    const std::vector<double> invLimit(4, 1.0 / 0.05);
+    const double scale = pyramid.saturate(u.data(), invLimit.data());
+    CHECK(scale < 1.0);
+    for (double ui : u) {
+        CHECK(std::abs(ui) <= 0.05 * (1.0 + 1e-12));
+    }
+    const Vec3 applied = pyramid.bodyTorque(u.data());
+    checkTorque(applied, {scale * tau[0], scale * tau[1], scale * tau[2]}, 1e-15);
+
+    // A correction that does not fit is cut to the remaining room
+    std::vector<double> v = {1.0, -1.0, -1.0, 1.0};
+    const double alpha = pyramid.addWithinLimits(u.data(), v.data(), limit.data());
+    CHECK(alpha >= 0.0 && alpha < 1.0);
+    for (double ui : u) {
+        CHECK(std::abs(ui) <= 0.05 * (1.0 + 1e-12));
+    }
+    checkTorque(pyramid.bodyTorque(u.data()), applied, 1e-15);
+}
+
+} // namespace
+
+int main() {
+    testFullRank();
+    testNullSpace();
+    testUnderActuated();
+    testSaturation();
+    return testing::testExitCode();
+}
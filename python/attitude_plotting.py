@@ -99,10 +99,12 @@ def plot_quaternion_components(result):
 # ------------------------------------------------
 def plot_euler_angles(result):
     t = np.array(result.time)
-    quats = np.array(result.quats)
-
-    quats_xyzw = np.stack([quats[:, 1], quats[:, 2], quats[:, 3], quats[:, 0]], axis=1)
-    euler = R.from_quat(quats_xyzw).as_euler("xyz", degrees=True)
+    if len(result.eulerAngles):
+        euler = np.rad2deg(result.eulerAngles)
+    else:
+        quats = np.array(result.quats)
+        quats_xyzw = np.stack([quats[:, 1], quats[:, 2], quats[:, 3], quats[:, 0]], axis=1)
+        euler = R.from_quat(quats_xyzw).as_euler("xyz", degrees=True)
 
     fig = go.Figure()
     _add_xyz_traces(fig, t, euler, ["Roll", "Pitch", "Yaw"])
@@ -128,11 +130,13 @@ def plot_angular_velocity(result):
 # ------------------------------------------------
 def plot_rotational_kinetic_energy(result, inertia_body):
     t = np.array(result.time)
-    omegas = np.array(result.omegas)
-    J = np.array(inertia_body, dtype=float).reshape(3, 3)
-
-    J_omega = omegas @ J.T
-    T = 0.5 * np.sum(omegas * J_omega, axis=1)
+    if len(result.kineticEnergy):
+        T = np.array(result.kineticEnergy)
+    else:
+        omegas = np.array(result.omegas)
+        J = np.array(inertia_body, dtype=float).reshape(3, 3)
+        J_omega = omegas @ J.T
+        T = 0.5 * np.sum(omegas * J_omega, axis=1)
 
     fig = go.Figure()
     _add_single_trace(fig, t, T, "Rotational KE")
@@ -158,8 +162,10 @@ def plot_attitude_error_components(result):
 # ------------------------------------------------
 def plot_attitude_error_norm(result):
     t = np.array(result.time)
-    e_att = np.array(result.attitudeError)
-    e_norm_deg = np.rad2deg(np.linalg.norm(e_att, axis=1))
+    if len(result.attitudeErrorNorm):
+        e_norm_deg = np.rad2deg(result.attitudeErrorNorm)
+    else:
+        e_norm_deg = np.rad2deg(np.linalg.norm(result.attitudeError, axis=1))
 
     fig = go.Figure()
     _add_single_trace(fig, t, e_norm_deg, "||e_att||")
@@ -185,8 +191,10 @@ def plot_rate_error_components(result):
 # ------------------------------------------------
 def plot_rate_error_norm(result):
     t = np.array(result.time)
-    e_rate = np.array(result.rateError)
-    e_norm = np.linalg.norm(e_rate, axis=1)
+    if len(result.rateErrorNorm):
+        e_norm = np.array(result.rateErrorNorm)
+    else:
+        e_norm = np.linalg.norm(result.rateError, axis=1)
 
     fig = go.Figure()
     _add_single_trace(fig, t, e_norm, "||e_w||")
@@ -219,3 +227,42 @@ def plot_torque(result):
 
     _apply_style(fig, "Commanded vs. Applied Torque", "Time [s]", "Torque [N·m]")
     fig.show()
+
+
+# ------------------------------------------------
+# Monte Carlo dispersion envelope
+# ------------------------------------------------
+def plot_dispersion_envelope(stats, channel, y_label="", colors=None):
+    # stats: DispersionStatistics from run_dispersion_batch. Per component:
+    # the mean, a mean ± σ band and the outermost quantiles as dashed lines.
+    t = np.array(stats.time)
+    env = stats[channel]
+    mean = np.array(env.mean)
+    sigma = np.array(env.stddev)
+    quantiles = [np.array(q) for q in env.quantiles]
+    if colors is None:
+        colors = _QUAT_COLORS if env.width == 4 else _XYZ_COLORS
+
+    fig = go.Figure()
+    for i in range(env.width):
+        color = colors[i % len(colors)]
+        label = f"{channel}[{i}]"
+        fig.add_trace(go.Scatter(
+            x=np.concatenate([t, t[::-1]]),
+            y=np.concatenate([mean[:, i] + sigma[:, i], (mean[:, i] - sigma[:, i])[::-1]]),
+            fill="toself", fillcolor=color, opacity=0.2, line=dict(width=0),
+            name=f"{label} ±1σ", hoverinfo="skip",
+        ))
+        fig.add_trace(go.Scatter(
+            x=t, y=mean[:, i], mode="lines",
+            name=f"{label} mean", line=dict(width=2.5, color=color),
+        ))
+        if quantiles:
+            for level, q in ((stats.quantiles[0], quantiles[0]), (stats.quantiles[-1], quantiles[-1])):
+                fig.add_trace(go.Scatter(
+                    x=t, y=q[:, i], mode="lines",
+                    name=f"{label} p{100 * level:g}", line=dict(width=1.5, color=color, dash="dash"),
+                ))
+
+    _apply_style(fig, f"Dispersion of {channel} ({stats.runs} runs)", "Time [s]", y_label or channel)
+    fig.show()
@@ -40,10 +40,18 @@ def build_lqr_gain(inertia_body, q_weights, w_weights, r_weights):
     try:
         from control import lqr
     except ImportError as e:
-        raise ImportError(
-            "python-control is required for build_lqr_gain. "
-            "Install with `pip install control`."
-        ) from e
+        # Fall back to the native solver in the C++ extension
+        try:
+            import starSense
+        except ImportError:
+            raise ImportError(
+                "python-control (or the starSense extension) is required for "
+                "build_lqr_gain. Install with `pip install control`."
+            ) from e
+        return np.asarray(
+            starSense.lqr_attitude_gain(inertia_body, q_weights, w_weights, r_weights),
+            dtype=float,
+        )
 
     J = np.array(inertia_body, dtype=float)
     if J.shape != (3, 3):
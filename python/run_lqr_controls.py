@@ -39,6 +39,9 @@ K_lqr = build_lqr_gain(params.inertiaBody, q_wts, w_wts, r_wts)  # 3x6
 params.kLqr = K_lqr.tolist()
 params.controlRateHz = 1
 
+# telemetry for the plots, computed during the run
+params.derivedChannels = True
+
 # run simulation
 out = starSense.run_simulation(params)
 
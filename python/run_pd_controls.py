@@ -54,6 +54,9 @@ params.maxWheelSpeed  = [6000, 6000, 6000]   # RPM
 # initial wheel speeds
 params.wheelSpeeds0 = [0.0, 0.0, 0.0]  # RPM
 
+# telemetry for the plots, computed during the run
+params.derivedChannels = True
+
 # run simulation
 out = starSense.run_simulation(params)
 